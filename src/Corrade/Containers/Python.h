@@ -25,11 +25,41 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
 #include <memory> /* :( */
 #include <pybind11/pybind11.h>
 
 namespace Corrade { namespace Containers {
 
+/* Type of a single item in a (byte) view. Views that have it set expose the
+   format and item size through the buffer protocol and convert items from and
+   to Python objects of given type instead of returning plain chars. Size and
+   stride of such views is still counted in items and bytes, respectively. */
+struct PyArrayViewFormat {
+    const char* format;
+    std::size_t itemsize;
+    pybind11::object(*getitem)(const char*);
+    void(*setitem)(char*, pybind11::handle);
+};
+
+/* Format description for arithmetic types. The memory isn't guaranteed to be
+   aligned, so it's copied instead of reinterpret_cast'd. */
+template<class T> const PyArrayViewFormat& pyArrayViewFormat() {
+    static const PyArrayViewFormat format{
+        pybind11::format_descriptor<T>::value, sizeof(T),
+        [](const char* item) -> pybind11::object {
+            T value;
+            std::memcpy(&value, item, sizeof(T));
+            return pybind11::cast(value);
+        },
+        [](char* item, pybind11::handle value) {
+            const T data = pybind11::cast<T>(value);
+            std::memcpy(item, &data, sizeof(T));
+        }
+    };
+    return format;
+}
+
 /* Stores additional stuff needed for proper refcounting of array views. Better
    than subclassing ArrayView because then we would need to wrap it every time
    it's exposed to Python, making 3rd party bindings unnecessarily complex. */
@@ -39,13 +69,16 @@ template<class T> struct PyArrayViewHolder: std::unique_ptr<T> {
         CORRADE_INTERNAL_ASSERT(!object->data());
     }
 
-    explicit PyArrayViewHolder(T* object, pybind11::object owner): std::unique_ptr<T>{object}, owner{std::move(owner)} {}
+    explicit PyArrayViewHolder(T* object, pybind11::object owner, const PyArrayViewFormat* format = nullptr): std::unique_ptr<T>{object}, owner{std::move(owner)}, format{format} {}
 
     pybind11::object owner;
+
+    /* If null, the items are bytes */
+    const PyArrayViewFormat* format;
 };
 
-template<class T> PyArrayViewHolder<T> pyArrayViewHolder(const T& view, pybind11::object owner) {
-    return PyArrayViewHolder<T>{new T{view}, owner};
+template<class T> PyArrayViewHolder<T> pyArrayViewHolder(const T& view, pybind11::object owner, const PyArrayViewFormat* format = nullptr) {
+    return PyArrayViewHolder<T>{new T{view}, owner, format};
 }
 
 }}
@@ -34,6 +34,34 @@
 
 namespace Magnum { namespace GL {
 
+/* Incremented by the platform application bindings every time they create a
+   GL context. A new context can be allocated at the address of a destroyed
+   one, so state cached for a context has to be keyed on the generation as
+   well. The counter is stored in pybind's shared data so all modules see the
+   same value. */
+inline std::size_t& pyContextGeneration() {
+    void* generation = pybind11::get_shared_data("magnum.gl.contextGeneration");
+    if(!generation)
+        generation = pybind11::set_shared_data("magnum.gl.contextGeneration", new std::size_t{});
+    return *static_cast<std::size_t*>(generation);
+}
+
+/* Installed by the gl module for other modules that draw meshes on their
+   own, so such draws are checked and counted in gl.stats() the same way as
+   Mesh.draw(). Stored in pybind's shared data as well, the pointers are null
+   until the gl module is loaded. */
+struct PyMeshDrawHooks {
+    void(*check)(GL::Mesh&);
+    void(*count)(std::size_t);
+};
+
+inline PyMeshDrawHooks& pyMeshDrawHooks() {
+    void* hooks = pybind11::get_shared_data("magnum.gl.meshDrawHooks");
+    if(!hooks)
+        hooks = pybind11::set_shared_data("magnum.gl.meshDrawHooks", new PyMeshDrawHooks{});
+    return *static_cast<PyMeshDrawHooks*>(hooks);
+}
+
 /* Stores additional stuff needed for proper refcounting of buffers owned by
    a mesh. For some reason it *has to be* templated, otherwise
    PYBIND11_DECLARE_HOLDER_TYPE doesn't work. Ugh. */
@@ -45,6 +73,28 @@ template<class T> struct PyMeshHolder: std::unique_ptr<T> {
     std::vector<pybind11::object> buffers;
 };
 
+/* Keeps the original mesh alive for as long as the view exists */
+template<class T> struct PyMeshViewHolder: std::unique_ptr<T> {
+    static_assert(std::is_same<T, GL::MeshView>::value, "mesh view holder has to hold a mesh view");
+
+    explicit PyMeshViewHolder(T* object): PyMeshViewHolder{object, pybind11::none{}} {}
+
+    explicit PyMeshViewHolder(T* object, pybind11::object mesh): std::unique_ptr<T>{object}, mesh{std::move(mesh)} {}
+
+    pybind11::object mesh;
+};
+
+#ifndef MAGNUM_TARGET_GLES2
+/* Keeps buffers attached to a transform feedback alive */
+template<class T> struct PyTransformFeedbackHolder: std::unique_ptr<T> {
+    static_assert(std::is_same<T, GL::TransformFeedback>::value, "transform feedback holder has to hold a transform feedback");
+
+    explicit PyTransformFeedbackHolder(T* object): std::unique_ptr<T>{object} {}
+
+    std::vector<pybind11::object> buffers;
+};
+#endif
+
 template<class T> struct PyFramebufferHolder: std::unique_ptr<T, PyNonDestructibleBaseDeleter<T, std::is_destructible<T>::value>> {
     static_assert(std::is_same<T, GL::Framebuffer>::value, "framebuffer holder has to hold a framebuffer");
 
@@ -56,6 +106,10 @@ template<class T> struct PyFramebufferHolder: std::unique_ptr<T, PyNonDestructib
 }}
 
 PYBIND11_DECLARE_HOLDER_TYPE(T, Magnum::GL::PyMeshHolder<T>)
+PYBIND11_DECLARE_HOLDER_TYPE(T, Magnum::GL::PyMeshViewHolder<T>)
 PYBIND11_DECLARE_HOLDER_TYPE(T, Magnum::GL::PyFramebufferHolder<T>)
+#ifndef MAGNUM_TARGET_GLES2
+PYBIND11_DECLARE_HOLDER_TYPE(T, Magnum::GL::PyTransformFeedbackHolder<T>)
+#endif
 
 #endif
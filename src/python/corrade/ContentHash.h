@@ -0,0 +1,177 @@
+#ifndef corrade_ContentHash_h
+#define corrade_ContentHash_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <Corrade/Containers/StridedArrayView.h>
+
+#include "bootstrap.h"
+
+namespace corrade {
+
+/* Streaming 64-bit content hash, implementing the XXH64 algorithm. The
+   result depends only on the byte sequence and not on how it got split into
+   pieces when feeding it in, which makes it possible to hash strided data
+   without copying them to a contiguous memory first. Input is read in the
+   platform byte order, so the value matches the reference XXH64 on
+   little-endian platforms. */
+class ContentHasher {
+    public:
+        void feed(const char* data, std::size_t size) {
+            _size += size;
+
+            /* Fill the partial stripe first */
+            if(_filled) {
+                const std::size_t count = size < StripeSize - _filled ? size : StripeSize - _filled;
+                std::memcpy(_stripe + _filled, data, count);
+                _filled += count;
+                data += count;
+                size -= count;
+                if(_filled != StripeSize) return;
+                hashStripe(_stripe);
+                _filled = 0;
+            }
+
+            /* Hash full stripes directly from the input */
+            for(; size >= StripeSize; data += StripeSize, size -= StripeSize)
+                hashStripe(data);
+
+            std::memcpy(_stripe, data, size);
+            _filled = size;
+        }
+
+        std::uint64_t digest() const {
+            std::uint64_t h;
+            if(_size >= StripeSize) {
+                h = rotl(_acc[0], 1) + rotl(_acc[1], 7) + rotl(_acc[2], 12) + rotl(_acc[3], 18);
+                for(const std::uint64_t acc: _acc) {
+                    h ^= round(0, acc);
+                    h = h*Prime1 + Prime4;
+                }
+            } else h = Prime5;
+            h += _size;
+
+            const char* data = _stripe;
+            std::size_t size = _filled;
+            for(; size >= 8; data += 8, size -= 8) {
+                h ^= round(0, read<std::uint64_t>(data));
+                h = rotl(h, 27)*Prime1 + Prime4;
+            }
+            if(size >= 4) {
+                h ^= std::uint64_t(read<std::uint32_t>(data))*Prime1;
+                h = rotl(h, 23)*Prime2 + Prime3;
+                data += 4;
+                size -= 4;
+            }
+            for(; size; ++data, --size) {
+                h ^= std::uint64_t(static_cast<unsigned char>(*data))*Prime5;
+                h = rotl(h, 11)*Prime1;
+            }
+
+            h ^= h >> 33;
+            h *= Prime2;
+            h ^= h >> 29;
+            h *= Prime3;
+            h ^= h >> 32;
+            return h;
+        }
+
+    private:
+        enum: std::size_t { StripeSize = 32 };
+        enum: std::uint64_t {
+            Prime1 = 11400714785074694791ull,
+            Prime2 = 14029467366897019727ull,
+            Prime3 = 1609587929392839161ull,
+            Prime4 = 9650029242287828579ull,
+            Prime5 = 2870177450012600261ull
+        };
+
+        static std::uint64_t rotl(const std::uint64_t value, const int bits) {
+            return (value << bits)|(value >> (64 - bits));
+        }
+
+        static std::uint64_t round(std::uint64_t acc, const std::uint64_t input) {
+            acc += input*Prime2;
+            return rotl(acc, 31)*Prime1;
+        }
+
+        /* The data can be at any offset, so not dereferencing directly */
+        template<class T> static T read(const char* data) {
+            T out;
+            std::memcpy(&out, data, sizeof(T));
+            return out;
+        }
+
+        void hashStripe(const char* data) {
+            for(std::size_t i = 0; i != 4; ++i)
+                _acc[i] = round(_acc[i], read<std::uint64_t>(data + i*8));
+        }
+
+        std::uint64_t _acc[4]{Prime1 + Prime2, Prime2, 0, 0 - std::uint64_t(Prime1)};
+        std::uint64_t _size{};
+        std::size_t _filled{};
+        char _stripe[StripeSize];
+};
+
+/* Feeds a strided view with items of given size into the hasher. Contiguous
+   parts are fed at once, the rest item by item. */
+template<unsigned dimensions> bool isContiguous(const Containers::StridedArrayView<dimensions, const char>& view, const std::size_t itemsize) {
+    const Containers::StridedDimensions<dimensions, std::size_t> size(view.size());
+    const Containers::StridedDimensions<dimensions, std::ptrdiff_t> stride(view.stride());
+    std::size_t expected = itemsize;
+    for(std::size_t i = dimensions; i != 0; --i) {
+        if(stride[i - 1] != std::ptrdiff_t(expected)) return false;
+        expected *= size[i - 1];
+    }
+    return true;
+}
+
+inline void contentHash(ContentHasher& hasher, const Containers::StridedArrayView1D<const char>& view, const std::size_t itemsize) {
+    if(isContiguous(view, itemsize))
+        hasher.feed(static_cast<const char*>(view.data()), view.size()*itemsize);
+    else for(const char& i: view)
+        hasher.feed(&i, itemsize);
+}
+
+template<unsigned dimensions> void contentHash(ContentHasher& hasher, const Containers::StridedArrayView<dimensions, const char>& view, const std::size_t itemsize) {
+    if(isContiguous(view, itemsize)) {
+        std::size_t size = itemsize;
+        for(std::size_t i = 0; i != dimensions; ++i) size *= view.size()[i];
+        hasher.feed(static_cast<const char*>(view.data()), size);
+    } else for(const Containers::StridedArrayView<dimensions - 1, const char> i: view)
+        contentHash(hasher, i, itemsize);
+}
+
+template<unsigned dimensions> std::uint64_t contentHash(const Containers::StridedArrayView<dimensions, const char>& view, const std::size_t itemsize) {
+    ContentHasher hasher;
+    contentHash(hasher, view, itemsize);
+    return hasher.digest();
+}
+
+}
+
+#endif
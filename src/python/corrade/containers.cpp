@@ -32,6 +32,7 @@
 #include "Corrade/Containers/Python.h"
 
 #include "corrade/bootstrap.h"
+#include "corrade/ContentHash.h"
 #include "corrade/PyBuffer.h"
 
 namespace corrade {
@@ -71,6 +72,29 @@ Slice calculateSlice(py::slice slice, std::size_t containerSize) {
     return Slice{std::size_t(start), std::size_t(stop), step};
 }
 
+/* Holder for a view derived from another, referencing the same memory owner
+   and having the same item format */
+template<class T, class U> Containers::PyArrayViewHolder<U> derivedArrayViewHolder(const U& view, const T& self) {
+    const auto& holder = pyObjectHolderFor<Containers::PyArrayViewHolder>(self);
+    return Containers::pyArrayViewHolder(view, holder.owner, holder.format);
+}
+
+/* Item retrieval and assignment, interpreting the memory according to the
+   format, if any */
+py::object getItem(const Containers::PyArrayViewFormat* format, const char& item) {
+    if(format) return format->getitem(&item);
+    return py::cast(item);
+}
+void setItem(const Containers::PyArrayViewFormat* format, char& item, py::handle value) {
+    /* A value of a wrong type would escape as a RuntimeError otherwise */
+    try {
+        if(format) format->setitem(&item, value);
+        else item = py::cast<char>(value);
+    } catch(const py::cast_error&) {
+        throw py::type_error{Utility::formatString("can't assign {} to a view item", std::string(py::str{value.get_type()}))};
+    }
+}
+
 template<class T> bool arrayViewBufferProtocol(T& self, Py_buffer& buffer, int flags) {
     if((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && !std::is_const<typename T::Type>::value) {
         PyErr_SetString(PyExc_BufferError, "array view is not writable");
@@ -140,6 +164,14 @@ template<class T> void arrayView(py::class_<Containers::ArrayView<T>, Containers
             return py::bytes(self.data(), self.size());
         }, "Convert to bytes")
 
+        /* Content hash */
+        .def("hash", [](const Containers::ArrayView<T>& self) {
+            py::gil_scoped_release release;
+            ContentHasher hasher;
+            hasher.feed(self.data(), self.size());
+            return hasher.digest();
+        }, "Hash of the contents")
+
         /* Single item retrieval. Need to throw IndexError in order to allow
            iteration: https://docs.python.org/3/reference/datamodel.html#object.__getitem__ */
         .def("__getitem__", [](const Containers::ArrayView<T>& self, std::size_t i) {
@@ -153,11 +185,11 @@ template<class T> void arrayView(py::class_<Containers::ArrayView<T>, Containers
 
             /* Non-trivial stride, return a different type */
             if(calculated.step != 1) {
-                return pyCastButNotShitty(Containers::pyArrayViewHolder(Containers::stridedArrayView(self).slice(calculated.start, calculated.stop).every(calculated.step), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner));
+                return pyCastButNotShitty(derivedArrayViewHolder(Containers::stridedArrayView(self).slice(calculated.start, calculated.stop).every(calculated.step), self));
             }
 
             /* Usual business */
-            return pyCastButNotShitty(Containers::pyArrayViewHolder(self.slice(calculated.start, calculated.stop), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner));
+            return pyCastButNotShitty(derivedArrayViewHolder(self.slice(calculated.start, calculated.stop), self));
         }, "Slice the view");
 
     enableBetterBufferProtocol<Containers::ArrayView<T>, arrayViewBufferProtocol>(c);
@@ -208,36 +240,48 @@ template<> std::tuple<std::ptrdiff_t, std::ptrdiff_t, std::ptrdiff_t, std::ptrdi
     return std::make_tuple(stride[0], stride[1], stride[2], stride[3]);
 }
 
-/* Byte conversion for given dimension */
-template<unsigned dimensions> Containers::Array<char> bytes(Containers::StridedArrayView<dimensions, const char>);
-template<> Containers::Array<char> bytes(Containers::StridedArrayView1D<const char> view) {
-    Containers::Array<char> out{view.size()};
+/* Byte conversion for given dimension. Each item is itemsize bytes. */
+template<unsigned dimensions> Containers::Array<char> bytes(Containers::StridedArrayView<dimensions, const char>, std::size_t);
+template<> Containers::Array<char> bytes(Containers::StridedArrayView1D<const char> view, std::size_t itemsize) {
+    Containers::Array<char> out{Containers::NoInit, view.size()*itemsize};
     std::size_t pos = 0;
-    for(const char i: view) out[pos++] = i;
+    for(const char& i: view) {
+        std::memcpy(out.data() + pos, &i, itemsize);
+        pos += itemsize;
+    }
     return out;
 }
-template<> Containers::Array<char> bytes(Containers::StridedArrayView2D<const char> view) {
-    Containers::Array<char> out{view.size()[0]*view.size()[1]};
+template<> Containers::Array<char> bytes(Containers::StridedArrayView2D<const char> view, std::size_t itemsize) {
+    Containers::Array<char> out{Containers::NoInit, view.size()[0]*view.size()[1]*itemsize};
     std::size_t pos = 0;
     for(Containers::StridedArrayView1D<const char> i: view)
-        for(const char j: i) out[pos++] = j;
+        for(const char& j: i) {
+            std::memcpy(out.data() + pos, &j, itemsize);
+            pos += itemsize;
+        }
     return out;
 }
-template<> Containers::Array<char> bytes(Containers::StridedArrayView3D<const char> view) {
-    Containers::Array<char> out{view.size()[0]*view.size()[1]*view.size()[2]};
+template<> Containers::Array<char> bytes(Containers::StridedArrayView3D<const char> view, std::size_t itemsize) {
+    Containers::Array<char> out{Containers::NoInit, view.size()[0]*view.size()[1]*view.size()[2]*itemsize};
     std::size_t pos = 0;
     for(Containers::StridedArrayView2D<const char> i: view)
         for(Containers::StridedArrayView1D<const char> j: i)
-            for(const char k: j) out[pos++] = k;
+            for(const char& k: j) {
+                std::memcpy(out.data() + pos, &k, itemsize);
+                pos += itemsize;
+            }
     return out;
 }
-template<> Containers::Array<char> bytes(Containers::StridedArrayView<4, const char> view) {
-    Containers::Array<char> out{view.size()[0]*view.size()[1]*view.size()[2]*view.size()[3]};
+template<> Containers::Array<char> bytes(Containers::StridedArrayView<4, const char> view, std::size_t itemsize) {
+    Containers::Array<char> out{Containers::NoInit, view.size()[0]*view.size()[1]*view.size()[2]*view.size()[3]*itemsize};
     std::size_t pos = 0;
     for(Containers::StridedArrayView3D<const char> i: view)
         for(Containers::StridedArrayView2D<const char> j: i)
             for(Containers::StridedArrayView1D<const char> k: j)
-                for(const char l: k) out[pos++] = l;
+                for(const char& l: k) {
+                    std::memcpy(out.data() + pos, &l, itemsize);
+                    pos += itemsize;
+                }
     return out;
 }
 
@@ -277,17 +321,20 @@ template<class T> bool stridedArrayViewBufferProtocol(T& self, Py_buffer& buffer
         return false;
     }
 
+    /* Views with a format have items larger than a byte */
+    const Containers::PyArrayViewFormat* format = pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format;
+
     /* I hate the const_casts but I assume this is to make editing easier, NOT
        to make it possible for users to stomp on these values. */
     buffer.ndim = T::Dimensions;
-    buffer.itemsize = sizeof(typename T::Type);
-    buffer.len = sizeof(typename T::Type);
+    buffer.itemsize = format ? format->itemsize : sizeof(typename T::Type);
+    buffer.len = buffer.itemsize;
     for(std::size_t i = 0; i != T::Dimensions; ++i)
         buffer.len *= Containers::Implementation::sizeRef(self)[i];
     buffer.buf = const_cast<typename std::decay<typename T::ErasedType>::type*>(self.data());
     buffer.readonly = std::is_const<typename T::Type>::value;
     if((flags & PyBUF_FORMAT) == PyBUF_FORMAT)
-        buffer.format = const_cast<char*>(FormatStrings[formatIndex<typename std::decay<typename T::Type>::type>()]);
+        buffer.format = const_cast<char*>(format ? format->format : FormatStrings[formatIndex<typename std::decay<typename T::Type>::type>()]);
     /* The view is immutable (can't change its size after it has been
        constructed), so referencing the size/stride directly is okay */
     buffer.shape = const_cast<Py_ssize_t*>(reinterpret_cast<const Py_ssize_t*>(Containers::Implementation::sizeRef(self).begin()));
@@ -358,15 +405,23 @@ template<unsigned dimensions, class T> void stridedArrayView(py::class_<Containe
 
         /* Conversion to bytes */
         .def("__bytes__", [](const Containers::StridedArrayView<dimensions, T>& self) {
+            const Containers::PyArrayViewFormat* format = pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format;
             /* TODO: use _PyBytes_Resize() to avoid the double copy */
-            const Containers::Array<char> out = bytes(Containers::arrayCast<const char>(self));
+            const Containers::Array<char> out = bytes(Containers::arrayCast<const char>(self), format ? format->itemsize : 1);
             return py::bytes(out.data(), out.size());
         }, "Convert to bytes")
 
+        /* Content hash */
+        .def("hash", [](const Containers::StridedArrayView<dimensions, T>& self) {
+            const Containers::PyArrayViewFormat* format = pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format;
+            py::gil_scoped_release release;
+            return contentHash(Containers::arrayCast<const char>(self), format ? format->itemsize : 1);
+        }, "Hash of the contents")
+
         /* Slicing of the top dimension */
         .def("__getitem__", [](const Containers::StridedArrayView<dimensions, T>& self, py::slice slice) {
             const Slice calculated = calculateSlice(slice, Containers::StridedDimensions<dimensions, const std::size_t>{self.size()}[0]);
-            return Containers::pyArrayViewHolder(self.slice(calculated.start, calculated.stop).every(calculated.step), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+            return derivedArrayViewHolder(self.slice(calculated.start, calculated.stop).every(calculated.step), self);
         }, "Slice the view");
 
     enableBetterBufferProtocol<Containers::StridedArrayView<dimensions, T>, stridedArrayViewBufferProtocol>(c);
@@ -378,7 +433,7 @@ template<class T> void stridedArrayView1D(py::class_<Containers::StridedArrayVie
            iteration: https://docs.python.org/3/reference/datamodel.html#object.__getitem__ */
         .def("__getitem__", [](const Containers::StridedArrayView<1, T>& self, std::size_t i) {
             if(i >= self.size()) throw pybind11::index_error{};
-            return self[i];
+            return getItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[i]);
         }, "Value at given position");
 }
 
@@ -388,7 +443,7 @@ template<unsigned dimensions, class T> void stridedArrayViewND(py::class_<Contai
            iteration: https://docs.python.org/3/reference/datamodel.html#object.__getitem__ */
         .def("__getitem__", [](const Containers::StridedArrayView<dimensions, T>& self, std::size_t i) {
             if(i >= Containers::StridedDimensions<dimensions, const std::size_t>{self.size()}[0]) throw pybind11::index_error{};
-            return Containers::pyArrayViewHolder(self[i], pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+            return derivedArrayViewHolder(self[i], self);
         }, "Sub-view at given position")
 
         /* Single-item retrieval. Need to throw IndexError in order to allow
@@ -407,7 +462,7 @@ template<unsigned dimensions, class T> void stridedArrayViewND(py::class_<Contai
                 steps[i] = calculated.step;
             }
 
-            return Containers::pyArrayViewHolder(self.slice(starts, stops).every(steps), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+            return derivedArrayViewHolder(self.slice(starts, stops).every(steps), self);
         }, "Slice the view");
 }
 
@@ -416,26 +471,26 @@ template<class T> void stridedArrayView2D(py::class_<Containers::StridedArrayVie
         .def("__getitem__", [](const Containers::StridedArrayView<2, T>& self, const std::tuple<std::size_t, std::size_t>& i) {
             if(std::get<0>(i) >= self.size()[0] ||
                std::get<1>(i) >= self.size()[1]) throw py::index_error{};
-            return self[std::get<0>(i)][std::get<1>(i)];
+            return getItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[std::get<0>(i)][std::get<1>(i)]);
         }, "Value at given position")
         .def("transposed", [](const Containers::StridedArrayView<2, T>& self, const std::size_t a, std::size_t b) {
             if((a == 0 && b == 1) ||
                (a == 1 && b == 0))
-                return Containers::pyArrayViewHolder(self.template transposed<0, 1>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<0, 1>(), self);
             throw py::value_error{Utility::formatString("dimensions {}, {} can't be transposed in a {}D view", a, b, 2)};
         }, "Transpose two dimensions")
         .def("flipped", [](const Containers::StridedArrayView<2, T>& self, const std::size_t dimension) {
             if(dimension == 0)
-                return Containers::pyArrayViewHolder(self.template flipped<0>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<0>(), self);
             if(dimension == 1)
-                return Containers::pyArrayViewHolder(self.template flipped<1>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<1>(), self);
             throw py::value_error{Utility::formatString("dimension {} out of range for a {}D view", dimension, 2)};
         }, "Flip a dimension")
         .def("broadcasted", [](const Containers::StridedArrayView<2, T>& self, const std::size_t dimension, std::size_t size) {
             if(dimension == 0)
-                return Containers::pyArrayViewHolder(self.template broadcasted<0>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<0>(size), self);
             if(dimension == 1)
-                return Containers::pyArrayViewHolder(self.template broadcasted<1>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<1>(size), self);
             throw py::value_error{Utility::formatString("dimension {} out of range for a {}D view", dimension, 2)};
         }, "Broadcast a dimension");
 }
@@ -446,36 +501,36 @@ template<class T> void stridedArrayView3D(py::class_<Containers::StridedArrayVie
             if(std::get<0>(i) >= self.size()[0] ||
                std::get<1>(i) >= self.size()[1] ||
                std::get<2>(i) >= self.size()[2]) throw pybind11::index_error{};
-            return self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)];
+            return getItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)]);
         }, "Value at given position")
         .def("transposed", [](const Containers::StridedArrayView<3, T>& self, const std::size_t a, std::size_t b) {
             if((a == 0 && b == 1) ||
                (a == 1 && b == 0))
-                return Containers::pyArrayViewHolder(self.template transposed<0, 1>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<0, 1>(), self);
             if((a == 0 && b == 2) ||
                (a == 2 && b == 0))
-                return Containers::pyArrayViewHolder(self.template transposed<0, 2>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<0, 2>(), self);
             if((a == 1 && b == 2) ||
                (a == 2 && b == 1))
-                return Containers::pyArrayViewHolder(self.template transposed<1, 2>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<1, 2>(), self);
             throw py::value_error{Utility::formatString("dimensions {}, {} can't be transposed in a {}D view", a, b, 3)};
         }, "Transpose two dimensions")
         .def("flipped", [](const Containers::StridedArrayView<3, T>& self, const std::size_t dimension) {
             if(dimension == 0)
-                return Containers::pyArrayViewHolder(self.template flipped<0>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<0>(), self);
             if(dimension == 1)
-                return Containers::pyArrayViewHolder(self.template flipped<1>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<1>(), self);
             if(dimension == 2)
-                return Containers::pyArrayViewHolder(self.template flipped<2>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<2>(), self);
             throw py::value_error{Utility::formatString("dimension {} out of range for a {}D view", dimension, 3)};
         }, "Flip a dimension")
         .def("broadcasted", [](const Containers::StridedArrayView<3, T>& self, const std::size_t dimension, std::size_t size) {
             if(dimension == 0)
-                return Containers::pyArrayViewHolder(self.template broadcasted<0>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<0>(size), self);
             if(dimension == 1)
-                return Containers::pyArrayViewHolder(self.template broadcasted<1>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<1>(size), self);
             if(dimension == 2)
-                return Containers::pyArrayViewHolder(self.template broadcasted<2>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<2>(size), self);
             throw py::value_error{Utility::formatString("dimension {} out of range for a {}D view", dimension, 3)};
         }, "Broadcast a dimension");
 }
@@ -487,88 +542,88 @@ template<class T> void stridedArrayView4D(py::class_<Containers::StridedArrayVie
                std::get<1>(i) >= self.size()[1] ||
                std::get<2>(i) >= self.size()[2] ||
                std::get<3>(i) >= self.size()[3]) throw pybind11::index_error{};
-            return self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)][std::get<3>(i)];
+            return getItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)][std::get<3>(i)]);
         }, "Value at given position")
         .def("transposed", [](const Containers::StridedArrayView<4, T>& self, const std::size_t a, std::size_t b) {
             if((a == 0 && b == 1) ||
                (a == 1 && b == 0))
-                return Containers::pyArrayViewHolder(self.template transposed<0, 1>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<0, 1>(), self);
             if((a == 0 && b == 2) ||
                (a == 2 && b == 0))
-                return Containers::pyArrayViewHolder(self.template transposed<0, 2>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<0, 2>(), self);
             if((a == 0 && b == 3) ||
                (a == 3 && b == 0))
-                return Containers::pyArrayViewHolder(self.template transposed<0, 3>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<0, 3>(), self);
             if((a == 1 && b == 2) ||
                (a == 2 && b == 1))
-                return Containers::pyArrayViewHolder(self.template transposed<1, 2>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<1, 2>(), self);
             if((a == 1 && b == 3) ||
                (a == 3 && b == 1))
-                return Containers::pyArrayViewHolder(self.template transposed<1, 3>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<1, 3>(), self);
             if((a == 2 && b == 3) ||
                (a == 3 && b == 2))
-                return Containers::pyArrayViewHolder(self.template transposed<2, 3>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template transposed<2, 3>(), self);
             throw py::value_error{Utility::formatString("dimensions {}, {} can't be transposed in a {}D view", a, b, 4)};
         }, "Transpose two dimensions")
         .def("flipped", [](const Containers::StridedArrayView<4, T>& self, const std::size_t dimension) {
             if(dimension == 0)
-                return Containers::pyArrayViewHolder(self.template flipped<0>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<0>(), self);
             if(dimension == 1)
-                return Containers::pyArrayViewHolder(self.template flipped<1>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<1>(), self);
             if(dimension == 2)
-                return Containers::pyArrayViewHolder(self.template flipped<2>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<2>(), self);
             if(dimension == 3)
-                return Containers::pyArrayViewHolder(self.template flipped<3>(), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template flipped<3>(), self);
             throw py::value_error{Utility::formatString("dimension {} out of range for a {}D view", dimension, 4)};
         }, "Flip a dimension")
         .def("broadcasted", [](const Containers::StridedArrayView<4, T>& self, const std::size_t dimension, std::size_t size) {
             if(dimension == 0)
-                return Containers::pyArrayViewHolder(self.template broadcasted<0>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<0>(size), self);
             if(dimension == 1)
-                return Containers::pyArrayViewHolder(self.template broadcasted<1>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<1>(size), self);
             if(dimension == 2)
-                return Containers::pyArrayViewHolder(self.template broadcasted<2>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<2>(size), self);
             if(dimension == 3)
-                return Containers::pyArrayViewHolder(self.template broadcasted<3>(size), pyObjectHolderFor<Containers::PyArrayViewHolder>(self).owner);
+                return derivedArrayViewHolder(self.template broadcasted<3>(size), self);
             throw py::value_error{Utility::formatString("dimension {} out of range for a {}D view", dimension, 4)};
         }, "Broadcast a dimension");
 }
 
 template<class T> void mutableStridedArrayView1D(py::class_<Containers::StridedArrayView<1, T>, Containers::PyArrayViewHolder<Containers::StridedArrayView<1, T>>>& c) {
     c
-        .def("__setitem__", [](const Containers::StridedArrayView<1, T>& self, const std::size_t i, const T& value) {
+        .def("__setitem__", [](const Containers::StridedArrayView<1, T>& self, const std::size_t i, py::handle value) {
             if(i >= self.size()) throw pybind11::index_error{};
-            self[i] = value;
+            setItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[i], value);
         }, "Set a value at given position");
 }
 
 template<class T> void mutableStridedArrayView2D(py::class_<Containers::StridedArrayView<2, T>, Containers::PyArrayViewHolder<Containers::StridedArrayView<2, T>>>& c) {
     c
-        .def("__setitem__", [](const Containers::StridedArrayView<2, T>& self, const std::tuple<std::size_t, std::size_t>& i, const T& value) {
+        .def("__setitem__", [](const Containers::StridedArrayView<2, T>& self, const std::tuple<std::size_t, std::size_t>& i, py::handle value) {
             if(std::get<0>(i) >= self.size()[0] ||
                std::get<1>(i) >= self.size()[1]) throw pybind11::index_error{};
-            self[std::get<0>(i)][std::get<1>(i)] = value;
+            setItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[std::get<0>(i)][std::get<1>(i)], value);
         }, "Set a value at given position");
 }
 
 template<class T> void mutableStridedArrayView3D(py::class_<Containers::StridedArrayView<3, T>, Containers::PyArrayViewHolder<Containers::StridedArrayView<3, T>>>& c) {
     c
-        .def("__setitem__", [](const Containers::StridedArrayView<3, T>& self, const std::tuple<std::size_t, std::size_t, std::size_t>& i, const T& value) {
+        .def("__setitem__", [](const Containers::StridedArrayView<3, T>& self, const std::tuple<std::size_t, std::size_t, std::size_t>& i, py::handle value) {
             if(std::get<0>(i) >= self.size()[0] ||
                std::get<1>(i) >= self.size()[1] ||
                std::get<2>(i) >= self.size()[2]) throw pybind11::index_error{};
-            self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)] = value;
+            setItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)], value);
         }, "Set a value at given position");
 }
 
 template<class T> void mutableStridedArrayView4D(py::class_<Containers::StridedArrayView<4, T>, Containers::PyArrayViewHolder<Containers::StridedArrayView<4, T>>>& c) {
     c
-        .def("__setitem__", [](const Containers::StridedArrayView<4, T>& self, const std::tuple<std::size_t, std::size_t, std::size_t, std::size_t>& i, const T& value) {
+        .def("__setitem__", [](const Containers::StridedArrayView<4, T>& self, const std::tuple<std::size_t, std::size_t, std::size_t, std::size_t>& i, py::handle value) {
             if(std::get<0>(i) >= self.size()[0] ||
                std::get<1>(i) >= self.size()[1] ||
                std::get<2>(i) >= self.size()[2] ||
                std::get<3>(i) >= self.size()[3]) throw pybind11::index_error{};
-            self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)][std::get<3>(i)] = value;
+            setItem(pyObjectHolderFor<Containers::PyArrayViewHolder>(self).format, self[std::get<0>(i)][std::get<1>(i)][std::get<2>(i)][std::get<3>(i)], value);
         }, "Set a value at given position");
 }
 
@@ -205,6 +205,19 @@ class ArrayView(unittest.TestCase):
         b[-1] = ord('?')
         self.assertEqual(a, b'World is hell?')
 
+    def test_hash(self):
+        a = containers.ArrayView(b'hello')
+        self.assertEqual(a.hash(), containers.ArrayView(bytearray(b'hello')).hash())
+        self.assertEqual(a.hash(), containers.MutableArrayView(bytearray(b'hello')).hash())
+        self.assertNotEqual(a.hash(), containers.ArrayView(b'hellO').hash())
+        self.assertNotEqual(a.hash(), containers.ArrayView(b'hell').hash())
+        self.assertNotEqual(containers.ArrayView().hash(), containers.ArrayView(b'\0').hash())
+
+        # Reference XXH64 values, input is read in little-endian order
+        if sys.byteorder == 'little':
+            self.assertEqual(containers.ArrayView().hash(), 0xef46db3751d8e999)
+            self.assertEqual(containers.ArrayView(b'abc').hash(), 0x44bc2cf5ad770999)
+
 class StridedArrayView1D(unittest.TestCase):
     def test_init(self):
         a = containers.StridedArrayView1D()
@@ -637,6 +650,20 @@ class StridedArrayView2D(unittest.TestCase):
         self.assertEqual(sys.getrefcount(a), a_refcount + 1)
         self.assertEqual(sys.getrefcount(b), b_refcount + 1)
 
+    def test_hash(self):
+        a = (b'01234567'
+             b'456789ab'
+             b'89abcdef')
+        v = memoryview(a).cast('b', shape=[3, 8])
+        b = containers.StridedArrayView2D(v)
+        self.assertEqual(b.hash(), containers.ArrayView(a).hash())
+
+        # Sparse views hash the same as their contiguous copy
+        c = b[::2, 1::3]
+        self.assertEqual(bytes(c), b'1479cf')
+        self.assertEqual(c.hash(), containers.ArrayView(b'1479cf').hash())
+        self.assertNotEqual(c.hash(), b[::2].hash())
+
 class StridedArrayView3D(unittest.TestCase):
     def test_init_buffer(self):
         a = (b'01234567'
@@ -88,5 +88,7 @@ __all__ = [
 
     'PixelFormat', 'PixelStorage',
     'ImageView1D', 'ImageView2D', 'ImageView3D',
-    'MutableImageView1D', 'MutableImageView2D', 'MutableImageView3D'
+    'MutableImageView1D', 'MutableImageView2D', 'MutableImageView3D',
+
+    'compare_images'
 ]
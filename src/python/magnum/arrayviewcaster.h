@@ -0,0 +1,150 @@
+#ifndef magnum_arrayviewcaster_h
+#define magnum_arrayviewcaster_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013, 2014, 2015, 2016, 2017, 2018, 2019
+              Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <pybind11/pybind11.h>
+#include <Corrade/Containers/Array.h>
+#include <Magnum/Magnum.h>
+#include <Magnum/Math/Color.h>
+
+/* Type caster for views on arrays of float vectors, used by setters such as
+   Phong.light_positions. A C-contiguous float32 buffer of shape (count, size)
+   is passed through as-is without any allocation or copy. Strided and
+   double buffers and sequences of vectors are converted to a temporary array
+   living for the duration of the call, same as a std::vector would be. With
+   implicit conversions disabled, only float buffers are accepted. */
+
+namespace magnum {
+
+template<class> struct IsFloatVector: std::false_type {};
+template<> struct IsFloatVector<Vector2>: std::true_type {};
+template<> struct IsFloatVector<Vector3>: std::true_type {};
+template<> struct IsFloatVector<Vector4>: std::true_type {};
+template<> struct IsFloatVector<Color3>: std::true_type {};
+template<> struct IsFloatVector<Color4>: std::true_type {};
+
+}
+
+namespace pybind11 { namespace detail {
+
+template<class T> struct type_caster<Magnum::Containers::ArrayView<const T>, enable_if_t<magnum::IsFloatVector<T>::value>> {
+    public:
+        PYBIND11_TYPE_CASTER(Magnum::Containers::ArrayView<const T>, _("List[") + make_caster<T>::name + _("]"));
+
+        type_caster() = default;
+        type_caster(const type_caster&) = delete;
+        type_caster& operator=(const type_caster&) = delete;
+
+        /* No-op if the buffer wasn't acquired */
+        ~type_caster() { PyBuffer_Release(&_buffer); }
+
+        bool load(handle src, bool convert) {
+            if(PyObject_CheckBuffer(src.ptr()))
+                return loadBuffer(src, convert);
+
+            if(!isinstance<sequence>(src) || isinstance<str>(src))
+                return false;
+
+            const auto items = reinterpret_borrow<sequence>(src);
+            _data = Magnum::Containers::Array<T>{Magnum::Containers::NoInit, items.size()};
+            for(std::size_t i = 0; i != items.size(); ++i) {
+                make_caster<T> item;
+                if(!item.load(items[i], convert)) return false;
+                _data[i] = cast_op<const T&>(item);
+            }
+            value = _data;
+            return true;
+        }
+
+        static handle cast(const Magnum::Containers::ArrayView<const T>& src, return_value_policy, handle) {
+            list out{src.size()};
+            for(std::size_t i = 0; i != src.size(); ++i)
+                out[i] = pybind11::cast(src[i]);
+            return out.release();
+        }
+
+    private:
+        /* Returns the type letter of a single-letter format in native byte
+           order, such as "f", "<f" or "=f", or '\0' for anything else */
+        static char nativeFormat(const char* format) {
+            if(format[0] == '@' || format[0] == '=' ||
+                #ifdef CORRADE_TARGET_BIG_ENDIAN
+                format[0] == '>' || format[0] == '!'
+                #else
+                format[0] == '<'
+                #endif
+            ) ++format;
+            return format[0] && !format[1] ? format[0] : '\0';
+        }
+
+        bool loadBuffer(handle src, bool convert) {
+            if(PyObject_GetBuffer(src.ptr(), &_buffer, PyBUF_FORMAT|PyBUF_STRIDES) != 0) {
+                PyErr_Clear();
+                return false;
+            }
+
+            /* Doubles are narrowed only if conversion is allowed, so float
+               overloads get picked first */
+            const char format = nativeFormat(_buffer.format);
+            if(_buffer.ndim != 2 || _buffer.shape[1] != T::Size || (format != 'f' && (format != 'd' || !convert))) {
+                PyBuffer_Release(&_buffer);
+                return false;
+            }
+
+            /* Fast path, the memory can be used directly */
+            if(format == 'f' && _buffer.strides[1] == sizeof(Magnum::Float) && _buffer.strides[0] == sizeof(T) && reinterpret_cast<std::uintptr_t>(_buffer.buf) % alignof(T) == 0) {
+                value = {static_cast<const T*>(_buffer.buf), std::size_t(_buffer.shape[0])};
+                return true;
+            }
+
+            /* Strides aren't guaranteed to keep the items aligned */
+            _data = Magnum::Containers::Array<T>{Magnum::Containers::NoInit, std::size_t(_buffer.shape[0])};
+            for(std::size_t i = 0; i != _data.size(); ++i) {
+                const char* item = static_cast<const char*>(_buffer.buf) + i*_buffer.strides[0];
+                for(std::size_t j = 0; j != T::Size; ++j) {
+                    const char* component = item + j*_buffer.strides[1];
+                    if(format == 'f') {
+                        std::memcpy(&_data[i][j], component, sizeof(Magnum::Float));
+                    } else {
+                        Magnum::Double d;
+                        std::memcpy(&d, component, sizeof(Magnum::Double));
+                        _data[i][j] = Magnum::Float(d);
+                    }
+                }
+            }
+            value = _data;
+            return true;
+        }
+
+        Py_buffer _buffer{};
+        Magnum::Containers::Array<T> _data;
+};
+
+}}
+
+#endif
@@ -23,23 +23,65 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> /* for Mesh.buffers */
-#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/Debug.h>
+#include <Corrade/Utility/Directory.h>
 #include <Corrade/Utility/FormatStl.h>
+#include <Corrade/Utility/MurmurHash2.h>
 #include <Magnum/ImageView.h>
+#include <Magnum/PixelFormat.h>
 #include <Magnum/GL/AbstractShaderProgram.h>
 #include <Magnum/GL/Attribute.h>
 #include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/BufferImage.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/CubeMapTexture.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
+#include <Magnum/GL/Extensions.h>
 #include <Magnum/GL/Framebuffer.h>
 #include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/MeshView.h>
+#include <Magnum/GL/OpenGL.h>
 #include <Magnum/GL/Renderer.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/Sampler.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Texture.h>
+#include <Magnum/GL/TextureFormat.h>
+#include <Magnum/GL/Version.h>
+#ifndef MAGNUM_TARGET_GLES2
+#include <Magnum/GL/PrimitiveQuery.h>
+#include <Magnum/GL/TextureArray.h>
+#include <Magnum/GL/TransformFeedback.h>
+#endif
+#if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+#include <Magnum/GL/SampleQuery.h>
+#endif
+#ifndef MAGNUM_TARGET_WEBGL
+#include <Magnum/GL/TimeQuery.h>
+#endif
 #include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix3.h>
+#include <Magnum/Math/Matrix4.h>
 
 #include "Corrade/Python.h"
+#include "Corrade/Containers/Python.h"
 #include "Magnum/Python.h"
 #include "Magnum/GL/Python.h"
 
@@ -55,6 +97,1109 @@ template<class T> struct NonDefaultFramebufferHolder: std::unique_ptr<T, PyNonDe
     explicit NonDefaultFramebufferHolder(T* object): std::unique_ptr<T, PyNonDestructibleBaseDeleter<T, std::is_destructible<T>::value>>{object} {}
 };
 
+/* Opt-in counters of GL operations done through the bindings. Only calls
+   made from Python are counted, not what Magnum or the builtin shaders do
+   internally. Everything is a no-op unless enabled. */
+struct Stats {
+    struct Counters {
+        UnsignedLong drawCalls, uploads, bytesUploaded, downloads, bytesDownloaded, staticReuploads, framebufferBinds, stateChanges, redundantStateChanges;
+    };
+
+    bool enabled;
+    Counters counters;
+    /* IDs of buffers filled with data marked as static */
+    std::unordered_set<GLuint> staticBuffers;
+};
+
+Stats& stats() {
+    static Stats stats{};
+    return stats;
+}
+
+void statsDraw(const std::size_t count = 1) {
+    Stats& s = stats();
+    if(s.enabled) s.counters.drawCalls += count;
+}
+
+void statsUpload(const std::size_t size) {
+    Stats& s = stats();
+    if(!s.enabled) return;
+    ++s.counters.uploads;
+    s.counters.bytesUploaded += size;
+}
+
+void statsDownload(const std::size_t size) {
+    Stats& s = stats();
+    if(!s.enabled) return;
+    ++s.counters.downloads;
+    s.counters.bytesDownloaded += size;
+}
+
+/* Counts the upload and remembers buffers filled with static data. Any
+   further upload to such buffer is counted as a static reupload. */
+void statsBufferUpload(GL::Buffer& buffer, const std::size_t size, const Containers::Optional<GL::BufferUsage> usage) {
+    Stats& s = stats();
+    if(!s.enabled) return;
+    statsUpload(size);
+
+    if(s.staticBuffers.count(buffer.id()))
+        ++s.counters.staticReuploads;
+    if(!usage) return;
+    if(*usage == GL::BufferUsage::StaticDraw || *usage == GL::BufferUsage::StaticRead || *usage == GL::BufferUsage::StaticCopy)
+        s.staticBuffers.insert(buffer.id());
+    else
+        s.staticBuffers.erase(buffer.id());
+}
+
+/* GL buffer IDs get reused once a buffer is deleted, so the deleted buffer
+   has to be forgotten, otherwise a new buffer with the same ID would be
+   treated as static */
+void statsBufferDeleted(const GL::Buffer& buffer) {
+    stats().staticBuffers.erase(buffer.id());
+}
+
+struct BufferDeleter {
+    void operator()(GL::Buffer* buffer) {
+        statsBufferDeleted(*buffer);
+        delete buffer;
+    }
+};
+
+/* Returns true if the state change should be skipped */
+bool statsStateChange(const bool redundant) {
+    Stats& s = stats();
+    if(s.enabled) {
+        ++s.counters.stateChanges;
+        if(redundant) ++s.counters.redundantStateChanges;
+    }
+    return redundant;
+}
+
+/* Last renderer state set through the bindings, used to skip redundant GL
+   calls. Everything is unknown until set for the first time. GL state
+   changed outside of the bindings isn't seen, which is why there's
+   Renderer.reset_state_cache(). The state is tied to the context it was set
+   in and gets discarded once a different context becomes current or a new
+   context is created by the platform application bindings. */
+struct RendererState {
+    GL::Context* context{};
+    std::size_t contextGeneration{};
+    std::unordered_map<GLenum, bool> features;
+    Containers::Optional<Color4> clearColor;
+};
+
+RendererState& rendererState() {
+    static RendererState state;
+    GL::Context* const context = GL::Context::hasCurrent() ? &GL::Context::current() : nullptr;
+    const std::size_t contextGeneration = GL::pyContextGeneration();
+    if(state.context != context || state.contextGeneration != contextGeneration) {
+        state.context = context;
+        state.contextGeneration = contextGeneration;
+        state.features.clear();
+        state.clearColor = Containers::NullOpt;
+    }
+    return state;
+}
+
+void rendererSetFeature(const GL::Renderer::Feature feature, const bool enabled) {
+    RendererState& state = rendererState();
+    const auto found = state.features.find(GLenum(feature));
+    if(statsStateChange(found != state.features.end() && found->second == enabled))
+        return;
+
+    GL::Renderer::setFeature(feature, enabled);
+    state.features[GLenum(feature)] = enabled;
+}
+
+void rendererSetClearColor(const Color4& color) {
+    RendererState& state = rendererState();
+    if(statsStateChange(state.clearColor && *state.clearColor == color))
+        return;
+
+    GL::Renderer::setClearColor(color);
+    state.clearColor = color;
+}
+
+/* Sub-allocates per-frame data from a single buffer. Allocations are
+   collected in a CPU-side staging copy and uploaded all at once in flush().
+   Every batch is appended after the previous one, so there's no need to
+   synchronize with draws still reading the earlier data. Once the end is
+   reached, the buffer storage gets orphaned and allocation starts from the
+   beginning again, again without having to wait for the GPU. */
+class StreamingBuffer {
+    public:
+        explicit StreamingBuffer(std::size_t capacity, GL::Buffer::TargetHint targetHint): _buffer{targetHint}, _staging{Containers::NoInit, capacity} {
+            /* The buffer isn't owned by a Python object, so the deleter isn't
+               called for it. Forget whatever had the same ID before instead. */
+            statsBufferDeleted(_buffer);
+            _buffer.setData({nullptr, capacity}, GL::BufferUsage::StreamDraw);
+        }
+
+        GL::Buffer& buffer() { return _buffer; }
+        std::size_t capacity() const { return _staging.size(); }
+        std::size_t offset() const { return _offset; }
+
+        std::size_t allocate(const Containers::ArrayView<const char> data, const std::size_t alignment) {
+            if(!alignment)
+                throw py::value_error{"alignment can't be zero"};
+            if(data.size() > _staging.size())
+                throw py::value_error{Utility::formatString("can't allocate {} bytes in a buffer of {} bytes", data.size(), _staging.size())};
+
+            std::size_t offset = (_offset + alignment - 1)/alignment*alignment;
+            if(offset + data.size() > _staging.size()) {
+                /* Offsets already returned for the current batch would be
+                   invalidated by orphaning, so wrap around only at batch
+                   boundaries */
+                if(_offset != _flushed)
+                    throw py::value_error{Utility::formatString("can't allocate {} bytes, only {} left until the end of the buffer; flush() first", data.size(), _staging.size() - std::min(offset, _staging.size()))};
+
+                _buffer.setData({nullptr, _staging.size()}, GL::BufferUsage::StreamDraw);
+                offset = _flushed = 0;
+            }
+
+            std::memcpy(_staging + offset, data.data(), data.size());
+            _offset = offset + data.size();
+            return offset;
+        }
+
+        void flush() {
+            if(_offset == _flushed) return;
+
+            const Containers::ArrayView<const char> data = _staging.slice(_flushed, _offset);
+            #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+            /* The range was never used by any draw since the last orphaning,
+               so it can be mapped without synchronization */
+            const Containers::ArrayView<char> mapped = _buffer.map(_flushed, data.size(), GL::Buffer::MapFlag::Write|GL::Buffer::MapFlag::InvalidateRange|GL::Buffer::MapFlag::Unsynchronized);
+            if(mapped) {
+                std::memcpy(mapped.data(), data.data(), data.size());
+                _buffer.unmap();
+            } else
+            #endif
+            {
+                _buffer.setSubData(_flushed, data);
+            }
+            statsUpload(data.size());
+
+            _flushed = _offset;
+        }
+
+    private:
+        GL::Buffer _buffer;
+        Containers::Array<char> _staging;
+        std::size_t _offset{}, _flushed{};
+};
+
+/* Buffers kept mapped by an unfinished AsyncUpload. Accessing them from
+   Python in the meantime would be a GL error or undefined behavior. */
+std::unordered_set<const GL::Buffer*>& uploadingBuffers() {
+    static std::unordered_set<const GL::Buffer*> buffers;
+    return buffers;
+}
+
+void checkNotUploading(const GL::Buffer& buffer) {
+    if(uploadingBuffers().count(&buffer))
+        throw std::runtime_error{"buffer has an async upload in progress"};
+}
+
+/* Drawing a mesh that sources a buffer which is still mapped is an error as
+   well. Buffers added from Python are all in the mesh holder, buffers owned
+   by the mesh itself are never uploaded asynchronously. */
+void checkMeshNotUploading(GL::Mesh& mesh) {
+    if(uploadingBuffers().empty()) return;
+    for(const py::object& buffer: pyObjectHolderFor<GL::PyMeshHolder>(mesh).buffers)
+        if(uploadingBuffers().count(&py::cast<const GL::Buffer&>(buffer)))
+            throw std::runtime_error{"mesh references a buffer with an async upload in progress"};
+}
+
+#if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+/* Not wrapped in Magnum itself, so using the GL API directly */
+class FenceSync {
+    public:
+        explicit FenceSync(): _sync{create()} {}
+
+        FenceSync(const FenceSync&) = delete;
+        FenceSync& operator=(const FenceSync&) = delete;
+
+        ~FenceSync() { glDeleteSync(_sync); }
+
+        /* Returns true if the fence is signaled, false on timeout */
+        bool wait(GLuint64 timeout) {
+            if(_signaled) return true;
+
+            /* Flush on the first wait, otherwise the fence might never get to
+               the GPU and waiting on it would hang */
+            const GLenum result = glClientWaitSync(_sync, _flushed ? 0 : GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            _flushed = true;
+            if(result == GL_WAIT_FAILED)
+                throw std::runtime_error{"fence wait failed"};
+            return _signaled = result != GL_TIMEOUT_EXPIRED;
+        }
+
+    private:
+        /* The functions would be null on older desktop contexts */
+        static GLsync create() {
+            #ifndef MAGNUM_TARGET_GLES
+            if(!GL::Context::current().isExtensionSupported<GL::Extensions::ARB::sync>())
+                throw std::runtime_error{"fence sync requires OpenGL 3.2 or ARB_sync"};
+            #endif
+            return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        GLsync _sync;
+        bool _flushed{}, _signaled{};
+};
+
+/* Framebuffer read into a pixel pack buffer, mapped once the fence gets
+   signaled. The mapping is kept until the object is destroyed. */
+class AsyncImageRead {
+    public:
+        explicit AsyncImageRead(GL::AbstractFramebuffer& framebuffer, const Range2Di& rectangle, PixelFormat format): _format{format}, _image{framebuffer.read(rectangle, GL::BufferImage2D{format}, GL::BufferUsage::StreamRead)} {
+            statsDownload(_image.dataSize());
+        }
+
+        ~AsyncImageRead() {
+            if(_data) _image.buffer().unmap();
+        }
+
+        /* Returns a null optional on timeout */
+        Containers::Optional<ImageView2D> wait(GLuint64 timeout) {
+            if(!_fence.wait(timeout)) return {};
+            if(!_data && _image.dataSize()) {
+                _data = _image.buffer().map(0, _image.dataSize(), GL::Buffer::MapFlag::Read);
+                if(!_data) throw std::runtime_error{"buffer mapping failed"};
+            }
+            return ImageView2D{_image.storage(), _format, _image.size(), _data};
+        }
+
+    private:
+        PixelFormat _format;
+        GL::BufferImage2D _image;
+        FenceSync _fence;
+        Containers::ArrayView<const char> _data;
+};
+
+/* Buffer range copied to a staging buffer on the GPU side, mapped once the
+   fence gets signaled. The mapping is kept until the object is destroyed. */
+class AsyncBufferRead {
+    public:
+        explicit AsyncBufferRead(GL::Buffer& buffer, GLintptr offset, GLsizeiptr size): _size{std::size_t(size)}, _buffer{copy(buffer, offset, size)} {
+            statsDownload(_size);
+        }
+
+        ~AsyncBufferRead() {
+            if(_data) _buffer.unmap();
+        }
+
+        /* Returns a null optional on timeout */
+        Containers::Optional<Containers::ArrayView<const char>> wait(GLuint64 timeout) {
+            if(!_fence.wait(timeout)) return {};
+            if(!_data && _size) {
+                _data = _buffer.map(0, _size, GL::Buffer::MapFlag::Read);
+                if(!_data) throw std::runtime_error{"buffer mapping failed"};
+            }
+            return _data;
+        }
+
+    private:
+        static GL::Buffer copy(GL::Buffer& buffer, GLintptr offset, GLsizeiptr size) {
+            #ifndef MAGNUM_TARGET_GLES
+            if(!GL::Context::current().isExtensionSupported<GL::Extensions::ARB::copy_buffer>())
+                throw std::runtime_error{"async buffer read requires OpenGL 3.1 or ARB_copy_buffer"};
+            #endif
+            GL::Buffer out{GL::Buffer::TargetHint::CopyWrite};
+            out.setData({nullptr, std::size_t(size)}, GL::BufferUsage::StreamRead);
+            if(size) GL::Buffer::copy(buffer, out, offset, 0, size);
+            return out;
+        }
+
+        std::size_t _size;
+        GL::Buffer _buffer;
+        FenceSync _fence;
+        Containers::ArrayView<const char> _data;
+};
+
+/* Shared contexts aren't exposed by the windowless applications, so all GL
+   calls stay on the main thread. The target buffer is mapped right away and
+   only the copy, which is where the time goes for large uploads, is done on
+   a worker thread. The buffer is unmapped and the remaining GL work is done
+   in finish(), once the copy is done. */
+class AsyncUpload {
+    public:
+        /* Buffer data upload */
+        explicit AsyncUpload(GL::Buffer& buffer, const Containers::ArrayView<const char> data, const GL::BufferUsage usage, py::object owner, py::object target): _buffer{&buffer}, _owner{std::move(owner)}, _target{std::move(target)} {
+            buffer.setData({nullptr, data.size()}, usage);
+            start(data);
+            statsBufferUpload(buffer, data.size(), usage);
+        }
+
+        /* Texture image upload through a pixel unpack buffer */
+        template<UnsignedInt dimensions, class T> explicit AsyncUpload(T& texture, const Int level, const VectorTypeFor<dimensions, Int>& offset, const BasicImageView<dimensions>& image, py::object owner, py::object target): _owner{std::move(owner)}, _target{std::move(target)} {
+            /* A shared pointer because std::function needs to be copyable */
+            std::shared_ptr<GL::BufferImage<dimensions>> bufferImage{new GL::BufferImage<dimensions>{image.storage(), image.format(), image.size(), {nullptr, image.data().size()}, GL::BufferUsage::StreamDraw}};
+            _buffer = &bufferImage->buffer();
+            _finish = [&texture, level, offset, bufferImage]() {
+                texture.setSubImage(level, offset, *bufferImage);
+            };
+            start(image.data());
+            statsUpload(image.data().size());
+        }
+
+        /* An upload that wasn't finished is finished here, otherwise a
+           texture upload would be silently dropped. A corrupted buffer can't
+           be reported from a destructor, so in that case the texture upload
+           is skipped. */
+        ~AsyncUpload() {
+            /* The worker has to be done before the mapping goes away */
+            if(_copy.valid()) _copy.wait();
+            if(_finished) return;
+            if(_mapped) {
+                uploadingBuffers().erase(_buffer);
+                if(!_buffer->unmap()) return;
+            }
+            if(_finish) _finish();
+        }
+
+        /* Returns true if the copy is done, false on timeout. Doesn't touch
+           any Python or GL state, so it can be called without the GIL. */
+        bool wait(const Containers::Optional<std::chrono::nanoseconds> timeout) {
+            if(!_copy.valid()) return true;
+            if(!timeout) {
+                _copy.wait();
+                return true;
+            }
+            return _copy.wait_for(*timeout) == std::future_status::ready;
+        }
+
+        /* Has to be called after wait() returned true */
+        void finish() {
+            if(_finished) return;
+            _finished = true;
+
+            if(_copy.valid()) _copy.get();
+            if(_mapped) {
+                _mapped = false;
+                uploadingBuffers().erase(_buffer);
+                if(!_buffer->unmap())
+                    throw std::runtime_error{"buffer data got corrupted during the upload"};
+            }
+            if(_finish) _finish();
+
+            /* Not needed anymore, let it go */
+            _owner = py::none{};
+        }
+
+    private:
+        void start(const Containers::ArrayView<const char> data) {
+            if(data.empty()) return;
+
+            const Containers::ArrayView<char> mapped = _buffer->map(0, data.size(), GL::Buffer::MapFlag::Write|GL::Buffer::MapFlag::InvalidateBuffer);
+            /* If mapping fails, upload synchronously */
+            if(!mapped) {
+                _buffer->setSubData(0, data);
+                return;
+            }
+
+            _mapped = true;
+            uploadingBuffers().insert(_buffer);
+            _copy = std::async(std::launch::async, [mapped, data]() {
+                std::memcpy(mapped.data(), data.data(), data.size());
+            });
+        }
+
+        GL::Buffer* _buffer;
+        py::object _owner, _target;
+        std::function<void()> _finish;
+        std::future<void> _copy;
+        bool _mapped{}, _finished{};
+};
+
+inline py::object pyAsyncReadResult(const ImageView2D& image, py::object owner) {
+    return pyCastButNotShitty(pyImageViewHolder(image, std::move(owner)));
+}
+
+inline py::object pyAsyncReadResult(const Containers::ArrayView<const char>& data, py::object owner) {
+    return pyCastButNotShitty(Containers::pyArrayViewHolder(data, std::move(owner)));
+}
+
+template<class T> void asyncRead(py::class_<T>& c) {
+    c
+        .def("poll", [](py::object self) -> py::object {
+            auto result = py::cast<T&>(self).wait(0);
+            if(!result) return py::none{};
+            return pyAsyncReadResult(*result, self);
+        }, "Get the data if it's ready")
+        .def("wait", [](py::object self, py::object timeout) -> py::object {
+            T& read = py::cast<T&>(self);
+            const GLuint64 timeoutNs = timeout.is_none() ? ~GLuint64{} : GLuint64(std::max(py::cast<Double>(timeout), 0.0)*1.0e9);
+            decltype(read.wait(0)) result;
+            {
+                py::gil_scoped_release release;
+                result = read.wait(timeoutNs);
+            }
+            if(!result) return py::none{};
+            return pyAsyncReadResult(*result, self);
+        }, "Wait for the data", py::arg("timeout") = py::none{});
+}
+#endif
+
+#ifndef MAGNUM_TARGET_WEBGL
+/* Reads buffer contents through a mapping, as glGetBufferSubData() isn't
+   available on ES */
+void readBuffer(GL::Buffer& buffer, GLintptr offset, const Containers::ArrayView<char> out) {
+    if(out.empty()) return;
+    const Containers::ArrayView<const char> data = buffer.map(offset, out.size(), GL::Buffer::MapFlag::Read);
+    if(!data) throw std::runtime_error{"buffer mapping failed"};
+    std::memcpy(out.data(), data.data(), out.size());
+    buffer.unmap();
+    statsDownload(out.size());
+}
+
+/* Reading directly into a bytearray to avoid copying the data once more */
+py::object readBufferToByteArray(GL::Buffer& buffer, GLintptr offset, GLsizeiptr size) {
+    py::object out = py::reinterpret_steal<py::object>(PyByteArray_FromStringAndSize(nullptr, size));
+    if(!out) throw py::error_already_set{};
+    readBuffer(buffer, offset, {PyByteArray_AS_STRING(out.ptr()), std::size_t(size)});
+    return out;
+}
+#endif
+
+#ifndef MAGNUM_TARGET_WEBGL
+/* Records CPU and GPU duration of named and possibly nested sections in a
+   frame. GPU time is measured using timestamp queries, whose results are
+   retrieved only once available, so it never stalls the pipeline unless more
+   than maxFrames frames are waiting for their results. Queries of resolved
+   frames are put back to a pool and reused by the next ones, so after the
+   first few frames no new query objects get created. */
+class FrameProfiler {
+    public:
+        struct Record {
+            UnsignedLong frame;
+            std::string name;
+            UnsignedInt depth;
+            Long cpuBegin, cpuDuration, gpuBegin, gpuDuration;
+        };
+
+        explicit FrameProfiler(std::size_t maxFrames): _maxFrames{maxFrames}, _epoch{std::chrono::steady_clock::now()} {
+            if(!maxFrames)
+                throw py::value_error{"max frame count can't be zero"};
+        }
+
+        std::size_t maxFrames() const { return _maxFrames; }
+
+        void beginFrame() {
+            if(_inFrame)
+                throw std::runtime_error{"a frame is already in progress"};
+            _inFrame = true;
+            _current.index = _frameCount++;
+            _current.sections.clear();
+        }
+
+        void begin(std::string name) {
+            if(!_inFrame)
+                throw std::runtime_error{"no frame in progress"};
+            _open.push_back(_current.sections.size());
+            _current.sections.emplace_back();
+            Section& section = _current.sections.back();
+            section.name = std::move(name);
+            section.depth = _open.size() - 1;
+            section.queries = acquireQueries();
+            section.cpuBegin = now();
+            section.queries.begin.timestamp();
+        }
+
+        void end() {
+            if(_open.empty())
+                throw std::runtime_error{"no section in progress"};
+            Section& section = _current.sections[_open.back()];
+            _open.pop_back();
+            section.queries.end.timestamp();
+            section.cpuEnd = now();
+        }
+
+        void endFrame() {
+            if(!_inFrame)
+                throw std::runtime_error{"no frame in progress"};
+            if(!_open.empty())
+                throw std::runtime_error{Utility::formatString("section {} is not ended", _current.sections[_open.back()].name)};
+            _inFrame = false;
+            _pending.push_back(std::move(_current));
+            _current = {};
+            resolve();
+        }
+
+        std::vector<Record> records() const {
+            std::vector<Record> out;
+            for(const std::vector<Record>& frame: _frames)
+                out.insert(out.end(), frame.begin(), frame.end());
+            return out;
+        }
+
+        std::string traceJson() const {
+            std::string out = "{\"traceEvents\":[";
+            bool first = true;
+            for(const std::vector<Record>& frame: _frames) for(const Record& record: frame) {
+                for(const bool gpu: {false, true}) {
+                    if(!first) out += ',';
+                    first = false;
+                    out += "{\"name\":\"";
+                    for(const char c: record.name) {
+                        if(c == '"' || c == '\\') out += '\\';
+                        out += UnsignedByte(c) < 0x20 ? ' ' : c;
+                    }
+                    out += Utility::formatString("\",\"cat\":\"{0}\",\"ph\":\"X\",\"pid\":0,\"tid\":{1},\"ts\":{2},\"dur\":{3},\"args\":",
+                        gpu ? "gpu" : "cpu", gpu ? 1 : 0,
+                        (gpu ? record.gpuBegin : record.cpuBegin)/1000.0,
+                        (gpu ? record.gpuDuration : record.cpuDuration)/1000.0);
+                    out += "{\"frame\":";
+                    out += std::to_string(record.frame);
+                    out += "}}";
+                }
+            }
+            out += "]}";
+            return out;
+        }
+
+    private:
+        struct Queries {
+            GL::TimeQuery begin{NoCreate}, end{NoCreate};
+        };
+
+        struct Section {
+            std::string name;
+            UnsignedInt depth;
+            Long cpuBegin, cpuEnd;
+            Queries queries;
+        };
+
+        struct Frame {
+            UnsignedLong index;
+            std::vector<Section> sections;
+        };
+
+        Long now() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _epoch).count();
+        }
+
+        Queries acquireQueries() {
+            Queries queries;
+            if(!_queryPool.empty()) {
+                queries = std::move(_queryPool.back());
+                _queryPool.pop_back();
+            } else {
+                queries.begin = GL::TimeQuery{GL::TimeQuery::Target::Timestamp};
+                queries.end = GL::TimeQuery{GL::TimeQuery::Target::Timestamp};
+            }
+            return queries;
+        }
+
+        void resolve() {
+            while(!_pending.empty()) {
+                Frame& frame = _pending.front();
+
+                /* Queries of the oldest frame are not ready yet -- if there's
+                   too many frames waiting, block, otherwise try again next
+                   time */
+                if(_pending.size() <= _maxFrames && !std::all_of(frame.sections.begin(), frame.sections.end(), [](Section& section) {
+                    return section.queries.end.resultAvailable();
+                })) break;
+
+                /* GPU and CPU clocks are different, align the GPU timestamps
+                   so the frame starts at the same time on both */
+                Long gpuOffset{};
+                if(!frame.sections.empty())
+                    gpuOffset = frame.sections.front().cpuBegin - Long(frame.sections.front().queries.begin.result<UnsignedLong>());
+
+                std::vector<Record> records;
+                records.reserve(frame.sections.size());
+                for(Section& section: frame.sections) {
+                    const Long gpuBegin = section.queries.begin.result<UnsignedLong>();
+                    const Long gpuEnd = section.queries.end.result<UnsignedLong>();
+                    records.push_back({frame.index, std::move(section.name), section.depth, section.cpuBegin, section.cpuEnd - section.cpuBegin, gpuBegin + gpuOffset, gpuEnd - gpuBegin});
+                    _queryPool.push_back(std::move(section.queries));
+                }
+
+                _frames.push_back(std::move(records));
+                if(_frames.size() > _maxFrames) _frames.pop_front();
+                _pending.pop_front();
+            }
+        }
+
+        std::size_t _maxFrames;
+        std::chrono::steady_clock::time_point _epoch;
+        UnsignedLong _frameCount{};
+        bool _inFrame{};
+        Frame _current{};
+        std::vector<std::size_t> _open;
+        std::deque<Frame> _pending;
+        std::deque<std::vector<Record>> _frames;
+        std::vector<Queries> _queryPool;
+};
+
+struct FrameProfilerScope {
+    FrameProfiler& profiler;
+    std::string name;
+};
+#endif
+
+/* AbstractShaderProgram with the protected APIs made public, so it can be
+   set up from Python */
+class ShaderProgram: public GL::AbstractShaderProgram {
+    public:
+        using GL::AbstractShaderProgram::attachShader;
+        using GL::AbstractShaderProgram::bindAttributeLocation;
+        #ifndef MAGNUM_TARGET_GLES
+        using GL::AbstractShaderProgram::bindFragmentDataLocation;
+        #endif
+        using GL::AbstractShaderProgram::link;
+        using GL::AbstractShaderProgram::uniformLocation;
+        #ifndef MAGNUM_TARGET_GLES2
+        using GL::AbstractShaderProgram::uniformBlockIndex;
+        using GL::AbstractShaderProgram::setUniformBlockBinding;
+        #endif
+        using GL::AbstractShaderProgram::setUniform;
+
+        /* Attribute and fragment data locations and transform feedback
+           outputs set through the bindings, in the order they were set. GL
+           has no way to query them before linking, so this is what
+           ProgramCache puts into its key. */
+        std::string linkState;
+};
+
+template<class T> void setUniform(ShaderProgram& self, Int location, const T& value) {
+    self.setUniform(location, value);
+}
+
+#if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+/* On-disk cache of linked program binaries. Program binaries aren't wrapped
+   in Magnum, so using the GL API directly. A cache file contains the binary
+   format, the full key and the binary. The key is stored to rule out hash
+   collisions, the driver strings in it make binaries from a different
+   driver miss the cache instead of failing to load. */
+class ProgramCache {
+    public:
+        explicit ProgramCache(const std::string& directory): _directory{directory} {
+            /* The query is an error and the functions are null on desktop GL
+               older than 4.1 without the extension */
+            GLint formatCount = 0;
+            #ifndef MAGNUM_TARGET_GLES
+            if(GL::Context::current().isExtensionSupported<GL::Extensions::ARB::get_program_binary>())
+            #endif
+            {
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+            }
+            _supported = formatCount > 0;
+            if(_supported && !Utility::Directory::mkpath(directory))
+                throw std::runtime_error{Utility::formatString("can't create cache directory {}", directory)};
+        }
+
+        const std::string& directory() const { return _directory; }
+        bool supported() const { return _supported; }
+        std::size_t hits() const { return _hits; }
+        std::size_t misses() const { return _misses; }
+
+        bool link(ShaderProgram& program, const std::vector<std::reference_wrapper<GL::Shader>>& shaders) {
+            if(!_supported) return compileAndLink(program, shaders);
+
+            GL::Context& context = GL::Context::current();
+            std::string key = context.vendorString() + '\n' + context.rendererString() + '\n' + context.versionString() + '\n';
+            for(GL::Shader& shader: shaders) {
+                key += std::to_string(GLenum(shader.type())) + '\n';
+                for(const std::string& source: shader.sources()) key += source;
+                key += '\n';
+            }
+            key += program.linkState;
+            const std::string filename = Utility::Directory::join(_directory, Utility::MurmurHash2{}(key).hexString() + ".bin");
+
+            if(load(program, filename, key)) {
+                ++_hits;
+                return true;
+            }
+
+            ++_misses;
+            glProgramParameteri(program.id(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            if(!compileAndLink(program, shaders)) return false;
+            save(program, filename, key);
+            return true;
+        }
+
+    private:
+        struct Header {
+            UnsignedInt format;
+            UnsignedInt keySize;
+        };
+
+        static bool compileAndLink(ShaderProgram& program, const std::vector<std::reference_wrapper<GL::Shader>>& shaders) {
+            for(GL::Shader& shader: shaders) {
+                if(!shader.compile()) return false;
+                program.attachShader(shader);
+            }
+            return program.link();
+        }
+
+        static bool load(ShaderProgram& program, const std::string& filename, const std::string& key) {
+            if(!Utility::Directory::exists(filename)) return false;
+
+            const Containers::Array<char> data = Utility::Directory::read(filename);
+            Header header;
+            if(data.size() < sizeof(Header)) return false;
+            std::memcpy(&header, data, sizeof(Header));
+            if(data.size() < sizeof(Header) + header.keySize || key.compare(0, std::string::npos, data + sizeof(Header), header.keySize) != 0)
+                return false;
+
+            /* Loading can fail for example after a driver update, in which
+               case the program gets linked from the sources again */
+            const std::size_t offset = sizeof(Header) + header.keySize;
+            glProgramBinary(program.id(), header.format, data + offset, data.size() - offset);
+            GLint linked;
+            glGetProgramiv(program.id(), GL_LINK_STATUS, &linked);
+            return linked == GL_TRUE;
+        }
+
+        static void save(ShaderProgram& program, const std::string& filename, const std::string& key) {
+            GLint size;
+            glGetProgramiv(program.id(), GL_PROGRAM_BINARY_LENGTH, &size);
+            if(!size) return;
+
+            Containers::Array<char> data{Containers::NoInit, sizeof(Header) + key.size() + std::size_t(size)};
+            Header header{0, UnsignedInt(key.size())};
+            GLenum format;
+            glGetProgramBinary(program.id(), size, nullptr, &format, data + sizeof(Header) + key.size());
+            header.format = format;
+            std::memcpy(data, &header, sizeof(Header));
+            std::memcpy(data + sizeof(Header), key.data(), key.size());
+
+            /* Writing to a temporary file first so other processes never see
+               a partially written one. Failures aren't fatal, the program
+               just gets linked again next time. */
+            const std::string temporary = filename + ".tmp";
+            if(Utility::Directory::write(temporary, data))
+                Utility::Directory::move(temporary, filename);
+        }
+
+        std::string _directory;
+        bool _supported;
+        std::size_t _hits{}, _misses{};
+};
+
+/* Same value for the KHR and ARB extension, might not be in the GL headers
+   bundled with Magnum */
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+/* The extension isn't known to Magnum, so looking into the extension
+   strings. The list is long, so it's done only once for each context, with
+   the same invalidation as rendererState(). */
+bool isParallelShaderCompileSupported() {
+    static GL::Context* context{};
+    static std::size_t contextGeneration{};
+    static bool supported{};
+    GL::Context& current = GL::Context::current();
+    const std::size_t currentGeneration = GL::pyContextGeneration();
+    if(context != &current || contextGeneration != currentGeneration) {
+        context = &current;
+        contextGeneration = currentGeneration;
+        const std::vector<std::string> extensions = current.extensionStrings();
+        supported =
+            std::find(extensions.begin(), extensions.end(), "GL_KHR_parallel_shader_compile") != extensions.end() ||
+            std::find(extensions.begin(), extensions.end(), "GL_ARB_parallel_shader_compile") != extensions.end();
+    }
+    return supported;
+}
+
+/* Compiles shaders and links a program without waiting for the result,
+   which is only checked in poll() or wait(). With KHR_parallel_shader_compile
+   the driver compiles in parallel and poll() can ask whether it's done
+   without blocking. Otherwise the driver may still defer the work until the
+   status is queried, but poll() has no way to know and reports it as done
+   right away. Magnum's GL::Shader::compile() and AbstractShaderProgram::link()
+   always query the status, so using the GL API directly. */
+class AsyncLink {
+    public:
+        explicit AsyncLink(ShaderProgram& program, const std::vector<std::reference_wrapper<GL::Shader>>& shaders, py::object programObject, py::object shaderObjects): _program{program}, _shaders{shaders.begin(), shaders.end()}, _programObject{std::move(programObject)}, _shaderObjects{std::move(shaderObjects)} {
+            for(GL::Shader& shader: shaders) {
+                const std::vector<std::string> sources = shader.sources();
+                std::vector<const GLchar*> pointers;
+                std::vector<GLint> sizes;
+                for(const std::string& source: sources) {
+                    pointers.push_back(source.data());
+                    sizes.push_back(source.size());
+                }
+                glShaderSource(shader.id(), pointers.size(), pointers.data(), sizes.data());
+                glCompileShader(shader.id());
+                program.attachShader(shader);
+            }
+            glLinkProgram(program.id());
+
+            _parallel = isParallelShaderCompileSupported();
+        }
+
+        bool parallel() const { return _parallel; }
+
+        /* Returns a null optional if not finished yet */
+        Containers::Optional<bool> poll() {
+            if(!_result && _parallel) {
+                GLint completed;
+                glGetProgramiv(_program.id(), GL_COMPLETION_STATUS_KHR, &completed);
+                if(!completed) return {};
+            }
+            return wait();
+        }
+
+        bool wait() {
+            if(!_result) _result = check();
+            return *_result;
+        }
+
+    private:
+        /* Prints the logs the same way as GL::Shader::compile() and
+           AbstractShaderProgram::link() would */
+        bool check() {
+            bool success = true;
+            for(GL::Shader& shader: _shaders) {
+                GLint compiled;
+                glGetShaderiv(shader.id(), GL_COMPILE_STATUS, &compiled);
+                if(compiled) continue;
+
+                success = false;
+                GLint size;
+                glGetShaderiv(shader.id(), GL_INFO_LOG_LENGTH, &size);
+                std::string message(std::max(size, 1), '\0');
+                glGetShaderInfoLog(shader.id(), message.size(), nullptr, &message[0]);
+                message.resize(std::max(size, 1) - 1);
+                Error{} << "gl.ShaderProgram.link_async(): compilation of shader" << shader.id() << "failed with the following message:" << Debug::newline << message;
+            }
+            if(!success) return false;
+
+            GLint linked;
+            glGetProgramiv(_program.id(), GL_LINK_STATUS, &linked);
+            if(linked) return true;
+
+            GLint size;
+            glGetProgramiv(_program.id(), GL_INFO_LOG_LENGTH, &size);
+            std::string message(std::max(size, 1), '\0');
+            glGetProgramInfoLog(_program.id(), message.size(), nullptr, &message[0]);
+            message.resize(std::max(size, 1) - 1);
+            Error{} << "gl.ShaderProgram.link_async(): linking failed with the following message:" << Debug::newline << message;
+            return false;
+        }
+
+        ShaderProgram& _program;
+        std::vector<std::reference_wrapper<GL::Shader>> _shaders;
+        /* Keeping the program and shaders alive until finished */
+        py::object _programObject, _shaderObjects;
+        bool _parallel;
+        Containers::Optional<bool> _result;
+};
+#endif
+
+#ifndef MAGNUM_TARGET_GLES2
+/* Draws a group of drawables, skipping the ones whose bounding box was
+   occluded in the previous frame. The queries are checked only once their
+   result is available, so the pipeline never stalls, at the cost of
+   objects appearing with a frame delay once they get unoccluded. The group
+   and camera are accessed only through their Python interface, to avoid a
+   dependency on the scene graph library. */
+class OcclusionCuller {
+    public:
+        explicit OcclusionCuller(): _boxVertices{GL::Buffer::TargetHint::Array}, _boxIndices{GL::Buffer::TargetHint::ElementArray} {
+            #ifndef MAGNUM_TARGET_GLES
+            const GL::Version version = GL::Version::GL330;
+            #else
+            const GL::Version version = GL::Version::GLES300;
+            #endif
+            GL::Shader vert{version, GL::Shader::Type::Vertex};
+            vert.addSource(
+                "layout(location = 0) in highp vec4 position;\n"
+                "uniform highp mat4 transformationProjectionMatrix;\n"
+                "void main() {\n"
+                "    gl_Position = transformationProjectionMatrix*position;\n"
+                "}\n");
+            GL::Shader frag{version, GL::Shader::Type::Fragment};
+            frag.addSource(
+                "out lowp vec4 color;\n"
+                "void main() {\n"
+                "    color = vec4(1.0);\n"
+                "}\n");
+            if(!GL::Shader::compile({vert, frag}))
+                throw std::runtime_error{"can't compile the bounding box shader"};
+            _shader.attachShader(vert);
+            _shader.attachShader(frag);
+            if(!_shader.link())
+                throw std::runtime_error{"can't link the bounding box shader"};
+            _transformationProjectionMatrixUniform = _shader.uniformLocation("transformationProjectionMatrix");
+
+            /* Unit cube, counterclockwise when looking from the outside */
+            constexpr Vector3 vertices[]{
+                {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f},
+                {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f},
+                {0.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}
+            };
+            constexpr UnsignedByte indices[]{
+                0, 2, 1, 1, 2, 3, /* -Z */
+                4, 5, 6, 5, 7, 6, /* +Z */
+                0, 4, 2, 2, 4, 6, /* -X */
+                1, 3, 5, 3, 7, 5, /* +X */
+                0, 1, 4, 1, 5, 4, /* -Y */
+                2, 6, 3, 3, 6, 7  /* +Y */
+            };
+            _boxVertices.setData(vertices, GL::BufferUsage::StaticDraw);
+            _boxIndices.setData(indices, GL::BufferUsage::StaticDraw);
+            _box.setCount(Containers::arraySize(indices))
+                .addVertexBuffer(_boxVertices, 0, GL::Attribute<0, Vector3>{})
+                .setIndexBuffer(_boxIndices, 0, GL::MeshIndexType::UnsignedByte);
+        }
+
+        std::size_t drawnCount() const { return _drawnCount; }
+        std::size_t culledCount() const { return _culledCount; }
+
+        void draw(const py::object& drawables, const py::object& camera) {
+            const Matrix4 cameraMatrix = py::cast<Matrix4>(camera.attr("camera_matrix"));
+            const Matrix4 projectionMatrix = py::cast<Matrix4>(camera.attr("projection_matrix"));
+            ++_frame;
+            _drawnCount = _culledCount = 0;
+
+            /* Draw everything that was visible in the previous frame, remember
+               boxes of everything to query afterwards */
+            std::vector<std::pair<Query*, Matrix4>> queries;
+            for(const py::handle drawable: drawables) {
+                const Matrix4 transformationMatrix = cameraMatrix*py::cast<Matrix4>(drawable.attr("object").attr("absolute_transformation_matrix")());
+
+                /* Drawables without a bounding box are always drawn */
+                const py::object boundsObject = py::getattr(drawable, "bounding_box", py::none{});
+                if(boundsObject.is_none()) {
+                    drawable.attr("draw")(transformationMatrix, camera);
+                    ++_drawnCount;
+                    continue;
+                }
+
+                const Range3D bounds = py::cast<Range3D>(boundsObject);
+                Query& query = _queries[drawable.ptr()];
+                if(!query.query) {
+                    query.drawable = py::reinterpret_borrow<py::object>(drawable);
+                    query.query.reset(new GL::SampleQuery{GL::SampleQuery::Target::AnySamplesPassed});
+                }
+                query.frame = _frame;
+
+                /* Take the result of the previous query, if there's any */
+                if(query.pending && query.query->resultAvailable()) {
+                    query.visible = query.query->result<bool>();
+                    query.pending = false;
+                }
+
+                /* The box faces would get clipped when the camera is inside,
+                   treat it as visible in that case */
+                const Vector3 cameraPosition = transformationMatrix.inverted().translation();
+                const bool inside = bounds.contains(cameraPosition);
+
+                if(query.visible || inside) {
+                    drawable.attr("draw")(transformationMatrix, camera);
+                    ++_drawnCount;
+                } else ++_culledCount;
+
+                /* Query again only once the previous result arrived */
+                if(!query.pending && !inside)
+                    queries.emplace_back(&query, projectionMatrix*transformationMatrix*Matrix4::translation(bounds.min())*Matrix4::scaling(bounds.size()));
+            }
+
+            /* Forget drawables that are no longer in the group */
+            for(auto it = _queries.begin(); it != _queries.end(); ) {
+                if(it->second.frame != _frame) it = _queries.erase(it);
+                else ++it;
+            }
+
+            if(queries.empty()) return;
+
+            /* Save the state changed by the box pass to restore it after.
+               Magnum has no getters for it, so asking GL directly. */
+            GLboolean colorMask[4], depthMask;
+            glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+            glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+            const bool faceCulling = glIsEnabled(GL_CULL_FACE);
+
+            /* Test the boxes against the depth buffer of the current frame.
+               Face culling is disabled so the result doesn't depend on how
+               the caller set it up. Blending doesn't matter with color
+               writes disabled. */
+            GL::Renderer::setColorMask(false, false, false, false);
+            GL::Renderer::setDepthMask(false);
+            if(faceCulling) GL::Renderer::disable(GL::Renderer::Feature::FaceCulling);
+            for(const std::pair<Query*, Matrix4>& query: queries) {
+                _shader.setUniform(_transformationProjectionMatrixUniform, query.second);
+                query.first->query->begin();
+                _box.draw(_shader);
+                query.first->query->end();
+                query.first->pending = true;
+            }
+            if(faceCulling) GL::Renderer::enable(GL::Renderer::Feature::FaceCulling);
+            GL::Renderer::setDepthMask(depthMask);
+            GL::Renderer::setColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+        }
+
+    private:
+        struct Query {
+            /* Keeping a reference so the pointer key can't get reused */
+            py::object drawable;
+            std::unique_ptr<GL::SampleQuery> query;
+            UnsignedLong frame;
+            bool visible{true}, pending{};
+        };
+
+        ShaderProgram _shader;
+        Int _transformationProjectionMatrixUniform;
+        GL::Buffer _boxVertices, _boxIndices;
+        GL::Mesh _box;
+        std::unordered_map<PyObject*, Query> _queries;
+        UnsignedLong _frame{};
+        std::size_t _drawnCount{}, _culledCount{};
+};
+#endif
+
+template<class T> void texture(PyNonDestructibleClass<T, GL::AbstractTexture>& c) {
+    c
+        .def(py::init(), "Constructor")
+
+        /* Using lambdas to avoid method chaining getting into signatures */
+
+        .def("set_minification_filter", [](T& self, GL::SamplerFilter filter, GL::SamplerMipmap mipmap) {
+            self.setMinificationFilter(filter, mipmap);
+        }, "Set minification filter", py::arg("filter"), py::arg("mipmap") = GL::SamplerMipmap::Base)
+        .def("set_magnification_filter", [](T& self, GL::SamplerFilter filter) {
+            self.setMagnificationFilter(filter);
+        }, "Set magnification filter", py::arg("filter"))
+        .def("set_wrapping", [](T& self, GL::SamplerWrapping wrapping) {
+            self.setWrapping(wrapping);
+        }, "Set wrapping", py::arg("wrapping"))
+        .def("generate_mipmap", [](T& self) {
+            self.generateMipmap();
+        }, "Generate mipmap");
+}
+
+template<UnsignedInt dimensions, class T> void textureImage(PyNonDestructibleClass<T, GL::AbstractTexture>& c) {
+    c
+        /* Using lambdas to avoid method chaining getting into signatures */
+        .def("set_storage", [](T& self, Int levels, GL::TextureFormat internalFormat, const VectorTypeFor<dimensions, Int>& size) {
+            self.setStorage(levels, internalFormat, size);
+        }, "Set storage", py::arg("levels"), py::arg("internal_format"), py::arg("size"))
+        .def("set_sub_image", [](T& self, Int level, const VectorTypeFor<dimensions, Int>& offset, const BasicImageView<dimensions>& image) {
+            self.setSubImage(level, offset, image);
+            statsUpload(image.data().size());
+        }, "Set image subdata", py::arg("level"), py::arg("offset"), py::arg("image"))
+        .def("set_sub_image", [](T& self, Int level, const VectorTypeFor<dimensions, Int>& offset, const BasicMutableImageView<dimensions>& image) {
+            self.setSubImage(level, offset, image);
+            statsUpload(image.data().size());
+        }, "Set image subdata", py::arg("level"), py::arg("offset"), py::arg("image"))
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        .def("set_sub_image_async", [](T& self, Int level, const VectorTypeFor<dimensions, Int>& offset, const BasicImageView<dimensions>& image) {
+            /* Keep a reference to the image data and the texture until the
+               upload finishes */
+            return new AsyncUpload{self, level, offset, image, pyObjectHolderFor<PyImageViewHolder>(image).owner, pyObjectFromInstance(self)};
+        }, "Set image subdata asynchronously", py::arg("level"), py::arg("offset"), py::arg("image"))
+        #endif
+        ;
+}
+
 }}
 
 PYBIND11_DECLARE_HOLDER_TYPE(T, magnum::NonDefaultFramebufferHolder<T>)
@@ -71,10 +1216,178 @@ void gl(py::module& m) {
 
     m.doc() = "OpenGL wrapping layer";
 
+    /* So draws done by other modules are checked and counted as well */
+    GL::pyMeshDrawHooks() = {checkMeshNotUploading, statsDraw};
+
+    /* Version */
+    py::enum_<GL::Version>{m, "Version", "OpenGL version"}
+        .value("NONE", GL::Version::None)
+        #ifndef MAGNUM_TARGET_GLES
+        .value("GL210", GL::Version::GL210)
+        .value("GL300", GL::Version::GL300)
+        .value("GL310", GL::Version::GL310)
+        .value("GL320", GL::Version::GL320)
+        .value("GL330", GL::Version::GL330)
+        .value("GL400", GL::Version::GL400)
+        .value("GL410", GL::Version::GL410)
+        .value("GL420", GL::Version::GL420)
+        .value("GL430", GL::Version::GL430)
+        .value("GL440", GL::Version::GL440)
+        .value("GL450", GL::Version::GL450)
+        .value("GL460", GL::Version::GL460)
+        #endif
+        .value("GLES200", GL::Version::GLES200)
+        .value("GLES300", GL::Version::GLES300)
+        #ifndef MAGNUM_TARGET_WEBGL
+        .value("GLES310", GL::Version::GLES310)
+        .value("GLES320", GL::Version::GLES320)
+        #endif
+        ;
+
+    /* Shader */
+    {
+        py::class_<GL::Shader> shader{m, "Shader", "Shader"};
+
+        py::enum_<GL::Shader::Type>{shader, "Type", "Shader type"}
+            .value("VERTEX", GL::Shader::Type::Vertex)
+            #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+            .value("TESSELLATION_CONTROL", GL::Shader::Type::TessellationControl)
+            .value("TESSELLATION_EVALUATION", GL::Shader::Type::TessellationEvaluation)
+            .value("GEOMETRY", GL::Shader::Type::Geometry)
+            .value("COMPUTE", GL::Shader::Type::Compute)
+            #endif
+            .value("FRAGMENT", GL::Shader::Type::Fragment);
+
+        shader
+            .def(py::init<GL::Version, GL::Shader::Type>(), "Constructor", py::arg("version"), py::arg("type"))
+            .def_property_readonly("id", &GL::Shader::id, "OpenGL shader ID")
+            .def_property_readonly("type", &GL::Shader::type, "Shader type")
+            .def_property_readonly("sources", &GL::Shader::sources, "Shader sources")
+            /* Using lambdas to avoid method chaining getting into signatures */
+            .def("add_source", [](GL::Shader& self, std::string source) {
+                self.addSource(std::move(source));
+            }, "Add shader source", py::arg("source"))
+            .def("add_file", [](GL::Shader& self, const std::string& filename) {
+                /* Magnum asserts on a nonexistent file */
+                if(!Utility::Directory::exists(filename)) {
+                    PyErr_SetString(PyExc_FileNotFoundError, Utility::formatString("file {} does not exist", filename).data());
+                    throw py::error_already_set{};
+                }
+                self.addFile(filename);
+            }, "Add shader source file", py::arg("filename"))
+            .def("compile", [](GL::Shader& self) {
+                return self.compile();
+            }, "Compile shader");
+    }
+
     /* Abstract shader program */
     PyNonDestructibleClass<GL::AbstractShaderProgram>{m,
-        "AbstractShaderProgram", "Base for shader program implementations"};
-    /** @todo more */
+        "AbstractShaderProgram", "Base for shader program implementations"}
+        .def_property_readonly("id", &GL::AbstractShaderProgram::id, "OpenGL program ID")
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        .def("dispatch_compute", [](GL::AbstractShaderProgram& self, const Vector3ui& workgroupCount) {
+            self.dispatchCompute(workgroupCount);
+        }, "Dispatch compute", py::arg("workgroup_count"))
+        #endif
+        /** @todo more */;
+
+    /* Shader program usable from Python */
+    {
+        PyNonDestructibleClass<ShaderProgram, GL::AbstractShaderProgram> shaderProgram{m,
+            "ShaderProgram", "Shader program"};
+
+        #ifndef MAGNUM_TARGET_GLES2
+        py::enum_<GL::AbstractShaderProgram::TransformFeedbackBufferMode>{shaderProgram, "TransformFeedbackBufferMode", "Buffer mode for transform feedback"}
+            .value("INTERLEAVED_ATTRIBUTES", GL::AbstractShaderProgram::TransformFeedbackBufferMode::InterleavedAttributes)
+            .value("SEPARATE_ATTRIBUTES", GL::AbstractShaderProgram::TransformFeedbackBufferMode::SeparateAttributes);
+        #endif
+
+        shaderProgram
+            .def(py::init(), "Constructor")
+            /* Using lambdas to avoid overload ambiguity and method chaining
+               getting into signatures */
+            .def("attach_shader", [](ShaderProgram& self, GL::Shader& shader) {
+                self.attachShader(shader);
+            }, "Attach a shader", py::arg("shader"))
+            .def("bind_attribute_location", [](ShaderProgram& self, UnsignedInt location, const std::string& name) {
+                self.bindAttributeLocation(location, name);
+                self.linkState += Utility::formatString("attribute {} {}\n", location, name);
+            }, "Bind an attribute to given location", py::arg("location"), py::arg("name"))
+            #ifndef MAGNUM_TARGET_GLES
+            .def("bind_fragment_data_location", [](ShaderProgram& self, UnsignedInt location, const std::string& name) {
+                self.bindFragmentDataLocation(location, name);
+                self.linkState += Utility::formatString("fragment {} {}\n", location, name);
+            }, "Bind fragment data to given location", py::arg("location"), py::arg("name"))
+            #endif
+            #ifndef MAGNUM_TARGET_GLES2
+            .def("set_transform_feedback_outputs", [](ShaderProgram& self, const std::vector<std::string>& outputs, GL::AbstractShaderProgram::TransformFeedbackBufferMode bufferMode) {
+                /* Magnum takes only an initializer list, so calling GL
+                   directly */
+                std::vector<const char*> names;
+                names.reserve(outputs.size());
+                self.linkState += Utility::formatString("feedback {}", GLenum(bufferMode));
+                for(const std::string& output: outputs) {
+                    names.push_back(output.data());
+                    self.linkState += ' ';
+                    self.linkState += output;
+                }
+                self.linkState += '\n';
+                glTransformFeedbackVaryings(self.id(), names.size(), names.data(), GLenum(bufferMode));
+            }, "Specify shader outputs to be recorded in transform feedback", py::arg("outputs"), py::arg("buffer_mode"))
+            #endif
+            .def("link", [](ShaderProgram& self) {
+                return self.link();
+            }, "Link the shader")
+            #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+            .def("link_async", [](ShaderProgram& self, py::object shaders) {
+                return new AsyncLink{self, py::cast<std::vector<std::reference_wrapper<GL::Shader>>>(shaders), pyObjectFromInstance(self), shaders};
+            }, "Compile shaders and link the program without waiting for the result", py::arg("shaders"))
+            #endif
+            .def("uniform_location", [](ShaderProgram& self, const std::string& name) {
+                return self.uniformLocation(name);
+            }, "Get uniform location", py::arg("name"))
+            #ifndef MAGNUM_TARGET_GLES2
+            .def("uniform_block_index", [](ShaderProgram& self, const std::string& name) {
+                return self.uniformBlockIndex(name);
+            }, "Get uniform block index", py::arg("name"))
+            .def("set_uniform_block_binding", [](ShaderProgram& self, UnsignedInt index, UnsignedInt binding) {
+                self.setUniformBlockBinding(index, binding);
+            }, "Set uniform block binding", py::arg("index"), py::arg("binding"))
+            #endif
+            /* Float types first, so values that need a conversion (such as
+               numpy scalars) pick the float overloads */
+            .def("set_uniform", setUniform<Float>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Vector2>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Vector3>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Vector4>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Int>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Vector2i>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Vector3i>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Vector4i>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Matrix3>, "Set uniform value", py::arg("location"), py::arg("value"))
+            .def("set_uniform", setUniform<Matrix4>, "Set uniform value", py::arg("location"), py::arg("value"));
+    }
+
+    #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    py::class_<AsyncLink>{m, "AsyncLink", "Asynchronous shader program link"}
+        .def_property_readonly("parallel", &AsyncLink::parallel,
+            "Whether the driver compiles in parallel and the completion can be polled")
+        .def("poll", [](AsyncLink& self) -> py::object {
+            const Containers::Optional<bool> result = self.poll();
+            if(!result) return py::none{};
+            return py::bool_{*result};
+        }, "Whether the link succeeded, if finished")
+        .def("wait", &AsyncLink::wait, "Wait for the link to finish");
+
+    py::class_<ProgramCache>{m, "ProgramCache", "On-disk cache of linked shader programs"}
+        .def(py::init<const std::string&>(), "Constructor", py::arg("directory"))
+        .def_property_readonly("directory", &ProgramCache::directory, "Cache directory")
+        .def_property_readonly("supported", &ProgramCache::supported,
+            "Whether the driver supports program binaries")
+        .def_property_readonly("hits", &ProgramCache::hits, "Count of programs loaded from the cache")
+        .def_property_readonly("misses", &ProgramCache::misses, "Count of programs compiled and linked from sources")
+        .def("link", &ProgramCache::link, "Load a linked program from the cache or compile and link it", py::arg("program"), py::arg("shaders"));
+    #endif
 
     /* (Dynamic) attribute */
     py::class_<GL::DynamicAttribute> attribute{m, "Attribute", "Vertex attribute location and type"};
@@ -151,7 +1464,7 @@ void gl(py::module& m) {
         #endif
         ;
 
-    py::class_<GL::Buffer> buffer{m, "Buffer", "Buffer"};
+    py::class_<GL::Buffer, std::unique_ptr<GL::Buffer, BufferDeleter>> buffer{m, "Buffer", "Buffer"};
 
     py::enum_<GL::Buffer::TargetHint>{buffer, "TargetHint", "Buffer target"}
         .value("ARRAY", GL::Buffer::TargetHint::Array)
@@ -183,16 +1496,138 @@ void gl(py::module& m) {
         #endif
         ;
 
+    #ifndef MAGNUM_TARGET_GLES2
+    py::enum_<GL::Buffer::Target>{buffer, "Target", "Buffer binding target"}
+        #ifndef MAGNUM_TARGET_WEBGL
+        .value("ATOMIC_COUNTER", GL::Buffer::Target::AtomicCounter)
+        .value("SHADER_STORAGE", GL::Buffer::Target::ShaderStorage)
+        #endif
+        .value("UNIFORM", GL::Buffer::Target::Uniform);
+    #endif
+
+    #ifndef MAGNUM_TARGET_WEBGL
+    py::enum_<GL::Buffer::MapFlag> bufferMapFlag{buffer, "MapFlag", "Memory mapping flag"};
+    bufferMapFlag
+        .value("READ", GL::Buffer::MapFlag::Read)
+        .value("WRITE", GL::Buffer::MapFlag::Write)
+        .value("INVALIDATE_RANGE", GL::Buffer::MapFlag::InvalidateRange)
+        .value("INVALIDATE_BUFFER", GL::Buffer::MapFlag::InvalidateBuffer)
+        .value("FLUSH_EXPLICIT", GL::Buffer::MapFlag::FlushExplicit)
+        .value("UNSYNCHRONIZED", GL::Buffer::MapFlag::Unsynchronized);
+    corrade::enumOperators(bufferMapFlag);
+    #endif
+
     buffer
         .def(py::init<GL::Buffer::TargetHint>(), "Constructor", py::arg("target_hint") = GL::Buffer::TargetHint::Array)
         .def_property_readonly("id", &GL::Buffer::id, "OpenGL buffer ID")
         .def_property("target_hint", &GL::Buffer::targetHint, &GL::Buffer::setTargetHint, "Target hint")
         /* Using lambdas to avoid method chaining getting into signatures */
         .def("set_data", [](GL::Buffer& self, const Containers::ArrayView<const char>& data, GL::BufferUsage usage) {
+            checkNotUploading(self);
             self.setData(data, usage);
+            statsBufferUpload(self, data.size(), usage);
         }, "Set buffer data", py::arg("data"), py::arg("usage") = GL::BufferUsage::StaticDraw)
+        #ifndef MAGNUM_TARGET_GLES2
+        .def("bind", [](GL::Buffer& self, GL::Buffer::Target target, UnsignedInt index) {
+            self.bind(target, index);
+        }, "Bind buffer to given binding index", py::arg("target"), py::arg("index"))
+        .def("bind", [](GL::Buffer& self, GL::Buffer::Target target, UnsignedInt index, GLintptr offset, GLsizeiptr size) {
+            self.bind(target, index, offset, size);
+        }, "Bind buffer range to given binding index", py::arg("target"), py::arg("index"), py::arg("offset"), py::arg("size"))
+        #endif
+        .def("set_sub_data", [](GL::Buffer& self, GLintptr offset, const Containers::ArrayView<const char>& data) {
+            if(offset < 0)
+                throw py::value_error{Utility::formatString("offset {} is negative", offset)};
+            checkNotUploading(self);
+            self.setSubData(offset, data);
+            statsBufferUpload(self, data.size(), {});
+        }, "Set buffer subdata", py::arg("offset"), py::arg("data"))
+        #ifndef MAGNUM_TARGET_WEBGL
+        .def("map", [](GL::Buffer& self, GLintptr offset, GLsizeiptr length, GL::Buffer::MapFlag flags) {
+            if(offset < 0 || length < 0)
+                throw py::value_error{Utility::formatString("can't map {} bytes at offset {}", length, offset)};
+            checkNotUploading(self);
+            const Containers::ArrayView<char> data = self.map(offset, length, flags);
+            if(!data && length)
+                throw std::runtime_error{"buffer mapping failed"};
+
+            /* The view references the buffer so it doesn't get deleted while
+               the memory is still accessed from Python. It's up to the user
+               to not access it after unmap() -- same as in C++. */
+            return Containers::pyArrayViewHolder(data, pyObjectFromInstance(self));
+        }, "Map buffer to client memory", py::arg("offset"), py::arg("length"), py::arg("flags") = GL::Buffer::MapFlag::Write)
+        .def("flush_mapped_range", [](GL::Buffer& self, GLintptr offset, GLsizeiptr length) {
+            self.flushMappedRange(offset, length);
+        }, "Flush mapped range", py::arg("offset"), py::arg("length"))
+        .def("unmap", &GL::Buffer::unmap, "Unmap buffer")
+        .def_property_readonly("size", &GL::Buffer::size, "Buffer size in bytes")
+        .def("data", [](GL::Buffer& self) {
+            checkNotUploading(self);
+            return readBufferToByteArray(self, 0, self.size());
+        }, "Buffer data")
+        .def("sub_data", [](GL::Buffer& self, GLintptr offset, GLsizeiptr size) {
+            if(offset < 0 || size < 0)
+                throw py::value_error{Utility::formatString("can't read {} bytes at offset {}", size, offset)};
+            checkNotUploading(self);
+            return readBufferToByteArray(self, offset, size);
+        }, "Buffer subdata", py::arg("offset"), py::arg("size"))
+        .def("sub_data", [](GL::Buffer& self, GLintptr offset, const Containers::ArrayView<char>& out) {
+            if(offset < 0)
+                throw py::value_error{Utility::formatString("can't read {} bytes at offset {}", out.size(), offset)};
+            checkNotUploading(self);
+            readBuffer(self, offset, out);
+        }, "Read buffer subdata into existing memory", py::arg("offset"), py::arg("out"))
+        #endif
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        .def("sub_data_async", [](GL::Buffer& self, GLintptr offset, GLsizeiptr size) {
+            if(offset < 0 || size < 0)
+                throw py::value_error{Utility::formatString("can't read {} bytes at offset {}", size, offset)};
+            checkNotUploading(self);
+            return new AsyncBufferRead{self, offset, size};
+        }, "Read buffer subdata asynchronously", py::arg("offset"), py::arg("size"))
+        .def("set_data_async", [](GL::Buffer& self, const Containers::ArrayView<const char>& data, GL::BufferUsage usage) {
+            checkNotUploading(self);
+            /* Keep a reference to the data and the buffer until the upload
+               finishes */
+            return new AsyncUpload{self, data, usage, pyObjectHolderFor<Containers::PyArrayViewHolder>(data).owner, pyObjectFromInstance(self)};
+        }, "Set buffer data asynchronously", py::arg("data"), py::arg("usage") = GL::BufferUsage::StaticDraw)
+        #endif
         /** @todo more */;
 
+    #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    {
+        py::class_<AsyncBufferRead> asyncBufferRead{m, "AsyncBufferRead", "Asynchronous buffer read"};
+        asyncRead(asyncBufferRead);
+    }
+
+    py::class_<AsyncUpload>{m, "AsyncUpload", "Asynchronous buffer or texture upload"}
+        .def("poll", [](AsyncUpload& self) {
+            if(!self.wait(std::chrono::nanoseconds{})) return false;
+            self.finish();
+            return true;
+        }, "Finish the upload if the data are copied")
+        .def("wait", [](AsyncUpload& self, py::object timeout) {
+            Containers::Optional<std::chrono::nanoseconds> timeoutNs;
+            if(!timeout.is_none())
+                timeoutNs = std::chrono::nanoseconds{Long(std::max(py::cast<Double>(timeout), 0.0)*1.0e9)};
+            bool done;
+            {
+                py::gil_scoped_release release;
+                done = self.wait(timeoutNs);
+            }
+            if(done) self.finish();
+            return done;
+        }, "Wait for the upload to finish", py::arg("timeout") = py::none{});
+    #endif
+
+    py::class_<StreamingBuffer>{m, "StreamingBuffer", "Streaming buffer for per-frame dynamic data"}
+        .def(py::init<std::size_t, GL::Buffer::TargetHint>(), "Constructor", py::arg("capacity"), py::arg("target_hint") = GL::Buffer::TargetHint::Array)
+        .def_property_readonly("buffer", &StreamingBuffer::buffer, "Underlying buffer")
+        .def_property_readonly("capacity", &StreamingBuffer::capacity, "Buffer capacity")
+        .def_property_readonly("offset", &StreamingBuffer::offset, "Offset after the last allocation")
+        .def("allocate", &StreamingBuffer::allocate, "Allocate data in the buffer", py::arg("data"), py::arg("alignment") = 1)
+        .def("flush", &StreamingBuffer::flush, "Upload all allocations made since the last flush");
+
     /* Renderbuffer */
     py::enum_<GL::RenderbufferFormat>{m, "RenderbufferFormat", "Internal renderbuffer format"}
         #ifndef MAGNUM_TARGET_GLES
@@ -295,6 +1730,158 @@ void gl(py::module& m) {
         .def("set_storage", &GL::Renderbuffer::setStorage, "Set renderbuffer storage")
         .def("set_storage_multisample", &GL::Renderbuffer::setStorageMultisample, "Set multisample renderbuffer storage");
 
+    /* Textures */
+    py::enum_<GL::SamplerFilter>{m, "SamplerFilter", "Texture sampler filtering"}
+        .value("NEAREST", GL::SamplerFilter::Nearest)
+        .value("LINEAR", GL::SamplerFilter::Linear);
+
+    py::enum_<GL::SamplerMipmap>{m, "SamplerMipmap", "Texture sampler mip level selection"}
+        .value("BASE", GL::SamplerMipmap::Base)
+        .value("NEAREST", GL::SamplerMipmap::Nearest)
+        .value("LINEAR", GL::SamplerMipmap::Linear);
+
+    py::enum_<GL::SamplerWrapping>{m, "SamplerWrapping", "Texture sampler wrapping"}
+        .value("REPEAT", GL::SamplerWrapping::Repeat)
+        .value("MIRRORED_REPEAT", GL::SamplerWrapping::MirroredRepeat)
+        .value("CLAMP_TO_EDGE", GL::SamplerWrapping::ClampToEdge)
+        #ifndef MAGNUM_TARGET_WEBGL
+        .value("CLAMP_TO_BORDER", GL::SamplerWrapping::ClampToBorder)
+        #endif
+        #ifndef MAGNUM_TARGET_GLES
+        .value("MIRROR_CLAMP_TO_EDGE", GL::SamplerWrapping::MirrorClampToEdge)
+        #endif
+        ;
+
+    py::enum_<GL::TextureFormat>{m, "TextureFormat", "Internal texture format"}
+        #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+        .value("R8", GL::TextureFormat::R8)
+        .value("RG8", GL::TextureFormat::RG8)
+        .value("RGB8", GL::TextureFormat::RGB8)
+        .value("RGBA8", GL::TextureFormat::RGBA8)
+        #endif
+        #ifndef MAGNUM_TARGET_GLES2
+        .value("R8_SNORM", GL::TextureFormat::R8Snorm)
+        .value("RG8_SNORM", GL::TextureFormat::RG8Snorm)
+        .value("RGB8_SNORM", GL::TextureFormat::RGB8Snorm)
+        .value("RGBA8_SNORM", GL::TextureFormat::RGBA8Snorm)
+        #endif
+        #ifndef MAGNUM_TARGET_GLES
+        .value("R16", GL::TextureFormat::R16)
+        .value("RG16", GL::TextureFormat::RG16)
+        .value("RGB16", GL::TextureFormat::RGB16)
+        .value("RGBA16", GL::TextureFormat::RGBA16)
+        #endif
+        #ifndef MAGNUM_TARGET_GLES2
+        .value("R8UI", GL::TextureFormat::R8UI)
+        .value("RG8UI", GL::TextureFormat::RG8UI)
+        .value("RGB8UI", GL::TextureFormat::RGB8UI)
+        .value("RGBA8UI", GL::TextureFormat::RGBA8UI)
+        .value("R8I", GL::TextureFormat::R8I)
+        .value("RG8I", GL::TextureFormat::RG8I)
+        .value("RGB8I", GL::TextureFormat::RGB8I)
+        .value("RGBA8I", GL::TextureFormat::RGBA8I)
+        .value("R16UI", GL::TextureFormat::R16UI)
+        .value("RG16UI", GL::TextureFormat::RG16UI)
+        .value("RGB16UI", GL::TextureFormat::RGB16UI)
+        .value("RGBA16UI", GL::TextureFormat::RGBA16UI)
+        .value("R16I", GL::TextureFormat::R16I)
+        .value("RG16I", GL::TextureFormat::RG16I)
+        .value("RGB16I", GL::TextureFormat::RGB16I)
+        .value("RGBA16I", GL::TextureFormat::RGBA16I)
+        .value("R32UI", GL::TextureFormat::R32UI)
+        .value("RG32UI", GL::TextureFormat::RG32UI)
+        .value("RGB32UI", GL::TextureFormat::RGB32UI)
+        .value("RGBA32UI", GL::TextureFormat::RGBA32UI)
+        .value("R32I", GL::TextureFormat::R32I)
+        .value("RG32I", GL::TextureFormat::RG32I)
+        .value("RGB32I", GL::TextureFormat::RGB32I)
+        .value("RGBA32I", GL::TextureFormat::RGBA32I)
+        .value("R16F", GL::TextureFormat::R16F)
+        .value("RG16F", GL::TextureFormat::RG16F)
+        .value("RGB16F", GL::TextureFormat::RGB16F)
+        .value("RGBA16F", GL::TextureFormat::RGBA16F)
+        .value("R32F", GL::TextureFormat::R32F)
+        .value("RG32F", GL::TextureFormat::RG32F)
+        .value("RGB32F", GL::TextureFormat::RGB32F)
+        .value("RGBA32F", GL::TextureFormat::RGBA32F)
+        .value("R11FG11FB10F", GL::TextureFormat::R11FG11FB10F)
+        .value("RGB9E5", GL::TextureFormat::RGB9E5)
+        .value("RGB10A2", GL::TextureFormat::RGB10A2)
+        .value("SRGB8", GL::TextureFormat::SRGB8)
+        #endif
+        #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+        .value("SRGB8_ALPHA8", GL::TextureFormat::SRGB8Alpha8)
+        #endif
+        .value("DEPTH_COMPONENT16", GL::TextureFormat::DepthComponent16)
+        #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+        .value("DEPTH_COMPONENT24", GL::TextureFormat::DepthComponent24)
+        .value("DEPTH24_STENCIL8", GL::TextureFormat::Depth24Stencil8)
+        #endif
+        #ifndef MAGNUM_TARGET_GLES2
+        .value("DEPTH_COMPONENT32F", GL::TextureFormat::DepthComponent32F)
+        .value("DEPTH32F_STENCIL8", GL::TextureFormat::Depth32FStencil8)
+        #endif
+        ;
+
+    PyNonDestructibleClass<GL::AbstractTexture>{m,
+        "AbstractTexture", "Base for textures"}
+        .def_property_readonly("id", &GL::AbstractTexture::id, "OpenGL texture ID")
+        .def("bind", static_cast<void(GL::AbstractTexture::*)(Int)>(&GL::AbstractTexture::bind),
+            "Bind texture to given texture unit", py::arg("texture_unit"));
+
+    {
+        PyNonDestructibleClass<GL::Texture2D, GL::AbstractTexture> texture2D{m,
+            "Texture2D", "Two-dimensional texture"};
+        texture(texture2D);
+        textureImage<2>(texture2D);
+    }
+
+    #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+    {
+        PyNonDestructibleClass<GL::Texture3D, GL::AbstractTexture> texture3D{m,
+            "Texture3D", "Three-dimensional texture"};
+        texture(texture3D);
+        textureImage<3>(texture3D);
+    }
+    #endif
+
+    #ifndef MAGNUM_TARGET_GLES2
+    {
+        PyNonDestructibleClass<GL::Texture2DArray, GL::AbstractTexture> texture2DArray{m,
+            "Texture2DArray", "Two-dimensional texture array"};
+        texture(texture2DArray);
+        textureImage<3>(texture2DArray);
+    }
+    #endif
+
+    {
+        PyNonDestructibleClass<GL::CubeMapTexture, GL::AbstractTexture> cubeMapTexture{m,
+            "CubeMapTexture", "Cube map texture"};
+
+        py::enum_<GL::CubeMapCoordinate>{m, "CubeMapCoordinate", "Cube map coordinate"}
+            .value("POSITIVE_X", GL::CubeMapCoordinate::PositiveX)
+            .value("NEGATIVE_X", GL::CubeMapCoordinate::NegativeX)
+            .value("POSITIVE_Y", GL::CubeMapCoordinate::PositiveY)
+            .value("NEGATIVE_Y", GL::CubeMapCoordinate::NegativeY)
+            .value("POSITIVE_Z", GL::CubeMapCoordinate::PositiveZ)
+            .value("NEGATIVE_Z", GL::CubeMapCoordinate::NegativeZ);
+
+        texture(cubeMapTexture);
+        cubeMapTexture
+            /* Using lambdas to avoid method chaining getting into signatures */
+            .def("set_storage", [](GL::CubeMapTexture& self, Int levels, GL::TextureFormat internalFormat, const Vector2i& size) {
+                self.setStorage(levels, internalFormat, size);
+            }, "Set storage", py::arg("levels"), py::arg("internal_format"), py::arg("size"))
+            .def("set_sub_image", [](GL::CubeMapTexture& self, GL::CubeMapCoordinate coordinate, Int level, const Vector2i& offset, const ImageView2D& image) {
+                self.setSubImage(coordinate, level, offset, image);
+                statsUpload(image.data().size());
+            }, "Set image subdata", py::arg("coordinate"), py::arg("level"), py::arg("offset"), py::arg("image"))
+            .def("set_sub_image", [](GL::CubeMapTexture& self, GL::CubeMapCoordinate coordinate, Int level, const Vector2i& offset, const MutableImageView2D& image) {
+                self.setSubImage(coordinate, level, offset, image);
+                statsUpload(image.data().size());
+            }, "Set image subdata", py::arg("coordinate"), py::arg("level"), py::arg("offset"), py::arg("image"));
+    }
+
     /* Framebuffers */
     py::enum_<GL::FramebufferClear> framebufferClear{m, "FramebufferClear", "Mask for framebuffer clearing"};
     framebufferClear
@@ -303,22 +1890,60 @@ void gl(py::module& m) {
         .value("STENCIL", GL::FramebufferClear::Stencil);
     corrade::enumOperators(framebufferClear);
 
+    #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+    py::enum_<GL::FramebufferBlit> framebufferBlit{m, "FramebufferBlit", "Mask for framebuffer blitting"};
+    framebufferBlit
+        .value("COLOR", GL::FramebufferBlit::Color)
+        .value("DEPTH", GL::FramebufferBlit::Depth)
+        .value("STENCIL", GL::FramebufferBlit::Stencil);
+    corrade::enumOperators(framebufferBlit);
+
+    py::enum_<GL::FramebufferBlitFilter>{m, "FramebufferBlitFilter", "Framebuffer blit filtering"}
+        .value("NEAREST", GL::FramebufferBlitFilter::Nearest)
+        .value("LINEAR", GL::FramebufferBlitFilter::Linear);
+    #endif
+
     py::class_<GL::AbstractFramebuffer, NonDefaultFramebufferHolder<GL::AbstractFramebuffer>> abstractFramebuffer{m,
         "AbstractFramebuffer", "Base for default and named framebuffers"};
 
     abstractFramebuffer
-        .def("bind", &GL::AbstractFramebuffer::bind,
-            "Bind framebuffer for drawing")
+        #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+        .def_static("blit", [](GL::AbstractFramebuffer& source, GL::AbstractFramebuffer& destination, const Range2Di& sourceRectangle, const Range2Di& destinationRectangle, GL::FramebufferBlit mask, GL::FramebufferBlitFilter filter) {
+            GL::AbstractFramebuffer::blit(source, destination, sourceRectangle, destinationRectangle, mask, filter);
+        }, "Copy a block of pixels", py::arg("source"), py::arg("destination"), py::arg("source_rectangle"), py::arg("destination_rectangle"), py::arg("mask"), py::arg("filter") = GL::FramebufferBlitFilter::Nearest)
+        .def_static("blit", [](GL::AbstractFramebuffer& source, GL::AbstractFramebuffer& destination, const Range2Di& rectangle, GL::FramebufferBlit mask) {
+            GL::AbstractFramebuffer::blit(source, destination, rectangle, mask);
+        }, "Copy a block of pixels", py::arg("source"), py::arg("destination"), py::arg("rectangle"), py::arg("mask"))
+        #endif
+        .def("bind", [](GL::AbstractFramebuffer& self) {
+            self.bind();
+            Stats& s = stats();
+            if(s.enabled) ++s.counters.framebufferBinds;
+        }, "Bind framebuffer for drawing")
         .def_property("viewport", &GL::AbstractFramebuffer::viewport, &GL::AbstractFramebuffer::setViewport,
             "Viewport")
         /* Using lambdas to avoid method chaining getting into signatures */
         .def("clear", [](GL::AbstractFramebuffer& self, GL::FramebufferClear mask) {
             self.clear(mask);
         }, "Clear specified buffers in the framebuffer")
-        .def("read", static_cast<void(GL::AbstractFramebuffer::*)(const Range2Di&, const MutableImageView2D&)>(&GL::AbstractFramebuffer::read),
-            "Read block of pixels from the framebuffer to an image view")
+        .def("read", [](GL::AbstractFramebuffer& self, const Range2Di& rectangle, const MutableImageView2D& image) {
+            self.read(rectangle, image);
+            statsDownload(image.data().size());
+        }, "Read block of pixels from the framebuffer to an image view")
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        .def("read_async", [](GL::AbstractFramebuffer& self, const Range2Di& rectangle, PixelFormat format) {
+            return new AsyncImageRead{self, rectangle, format};
+        }, "Read block of pixels from the framebuffer asynchronously", py::arg("rectangle"), py::arg("format"))
+        #endif
         /** @todo more */;
 
+    #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+    {
+        py::class_<AsyncImageRead> asyncImageRead{m, "AsyncImageRead", "Asynchronous framebuffer read"};
+        asyncRead(asyncImageRead);
+    }
+    #endif
+
     py::class_<GL::DefaultFramebuffer, GL::AbstractFramebuffer, NonDefaultFramebufferHolder<GL::DefaultFramebuffer>> defaultFramebuffer{m,
         "DefaultFramebuffer", "Default framebuffer"};
 
@@ -363,6 +1988,13 @@ void gl(py::module& m) {
                before the framebuffer */
             pyObjectHolderFor<GL::PyFramebufferHolder>(self).attachments.emplace_back(pyObjectFromInstance(renderbuffer));
         }, "Attach renderbuffer to given buffer")
+        .def("attach_texture", [](GL::Framebuffer& self, GL::Framebuffer::BufferAttachment attachment, GL::Texture2D& texture, Int level) {
+            self.attachTexture(attachment, texture, level);
+
+            /* Keep a reference to the texture to avoid it being deleted
+               before the framebuffer */
+            pyObjectHolderFor<GL::PyFramebufferHolder>(self).attachments.emplace_back(pyObjectFromInstance(texture));
+        }, "Attach texture to given buffer", py::arg("attachment"), py::arg("texture"), py::arg("level") = 0)
 
         .def_property_readonly("attachments", [](GL::Framebuffer& self) {
             return pyObjectHolderFor<GL::PyFramebufferHolder>(self).attachments;
@@ -396,6 +2028,11 @@ void gl(py::module& m) {
         #endif
         ;
 
+    py::enum_<GL::MeshIndexType>{m, "MeshIndexType", "Mesh index type"}
+        .value("UNSIGNED_BYTE", GL::MeshIndexType::UnsignedByte)
+        .value("UNSIGNED_SHORT", GL::MeshIndexType::UnsignedShort)
+        .value("UNSIGNED_INT", GL::MeshIndexType::UnsignedInt);
+
     py::class_<GL::Mesh, GL::PyMeshHolder<GL::Mesh>>{m, "Mesh", "Mesh"}
         .def(py::init<GL::MeshPrimitive>(), "Constructor", py::arg("primitive") = GL::MeshPrimitive::Triangles)
         .def(py::init<MeshPrimitive>(), "Constructor")
@@ -413,6 +2050,14 @@ void gl(py::module& m) {
         .def_property("count", &GL::Mesh::count, [](GL::Mesh& self, UnsignedInt count) {
             self.setCount(count);
         }, "Vertex/index count")
+        .def_property("instance_count", &GL::Mesh::instanceCount, [](GL::Mesh& self, Int count) {
+            self.setInstanceCount(count);
+        }, "Instance count")
+        #ifndef MAGNUM_TARGET_GLES
+        .def_property("base_instance", &GL::Mesh::baseInstance, [](GL::Mesh& self, UnsignedInt baseInstance) {
+            self.setBaseInstance(baseInstance);
+        }, "Base instance")
+        #endif
 
         /* Using lambdas to avoid method chaining getting into signatures */
 
@@ -423,8 +2068,38 @@ void gl(py::module& m) {
                the mesh */
             pyObjectHolderFor<GL::PyMeshHolder>(self).buffers.emplace_back(pyObjectFromInstance(buffer));
         }, "Add vertex buffer", py::arg("buffer"), py::arg("offset"), py::arg("stride"), py::arg("attribute"))
+        .def("add_vertex_buffer_instanced", [](GL::Mesh& self, GL::Buffer& buffer, UnsignedInt divisor, GLintptr offset, GLsizei stride, const GL::DynamicAttribute& attribute) {
+            self.addVertexBufferInstanced(buffer, divisor, offset, stride, attribute);
+
+            /* Keep a reference to the buffer to avoid it being deleted before
+               the mesh */
+            pyObjectHolderFor<GL::PyMeshHolder>(self).buffers.emplace_back(pyObjectFromInstance(buffer));
+        }, "Add instanced vertex buffer", py::arg("buffer"), py::arg("divisor"), py::arg("offset"), py::arg("stride"), py::arg("attribute"))
+        .def("set_index_buffer", [](GL::Mesh& self, GL::Buffer& buffer, GLintptr offset, py::object type, UnsignedInt start, UnsignedInt end) {
+            if(py::isinstance<MeshIndexType>(type))
+                self.setIndexBuffer(buffer, offset, py::cast<MeshIndexType>(type), start, end);
+            else if(py::isinstance<GL::MeshIndexType>(type))
+                self.setIndexBuffer(buffer, offset, py::cast<GL::MeshIndexType>(type), start, end);
+            else throw py::type_error{Utility::formatString("expected MeshIndexType or gl.MeshIndexType, got {}", std::string(py::str{type.get_type()}))};
+
+            /* Keep a reference to the buffer to avoid it being deleted before
+               the mesh */
+            pyObjectHolderFor<GL::PyMeshHolder>(self).buffers.emplace_back(pyObjectFromInstance(buffer));
+        }, "Set index buffer", py::arg("buffer"), py::arg("offset"), py::arg("type"), py::arg("start") = 0, py::arg("end") = 0)
+        .def_property_readonly("is_indexed", &GL::Mesh::isIndexed, "Whether the mesh is indexed")
+        .def_property_readonly("index_type", [](GL::Mesh& self) -> py::object {
+            if(!self.isIndexed()) return py::none{};
+            return py::cast(self.indexType());
+        }, "Index type")
+        #ifndef MAGNUM_TARGET_WEBGL
+        .def_property("base_vertex", &GL::Mesh::baseVertex, [](GL::Mesh& self, Int baseVertex) {
+            self.setBaseVertex(baseVertex);
+        }, "Base vertex")
+        #endif
         .def("draw", [](GL::Mesh& self, GL::AbstractShaderProgram& shader) {
+            checkMeshNotUploading(self);
             self.draw(shader);
+            statsDraw();
         }, "Draw the mesh")
         /** @todo more */
 
@@ -432,6 +2107,213 @@ void gl(py::module& m) {
             return pyObjectHolderFor<GL::PyMeshHolder>(self).buffers;
         }, "Buffer objects referenced by the mesh");
 
+    py::class_<GL::MeshView, GL::PyMeshViewHolder<GL::MeshView>>{m, "MeshView", "Mesh view"}
+        .def(py::init([](GL::Mesh& mesh) {
+            return GL::PyMeshViewHolder<GL::MeshView>{new GL::MeshView{mesh}, pyObjectFromInstance(mesh)};
+        }), "Constructor", py::arg("original"))
+        /* Using lambdas to avoid method chaining getting into signatures */
+        .def_property("count", &GL::MeshView::count, [](GL::MeshView& self, Int count) {
+            self.setCount(count);
+        }, "Vertex/index count")
+        #ifndef MAGNUM_TARGET_WEBGL
+        .def_property("base_vertex", &GL::MeshView::baseVertex, [](GL::MeshView& self, Int baseVertex) {
+            self.setBaseVertex(baseVertex);
+        }, "Base vertex")
+        #endif
+        .def("set_index_range", [](GL::MeshView& self, Int first, UnsignedInt start, UnsignedInt end) {
+            self.setIndexRange(first, start, end);
+        }, "Set index range", py::arg("first"), py::arg("start") = 0, py::arg("end") = 0)
+        .def_property("instance_count", &GL::MeshView::instanceCount, [](GL::MeshView& self, Int count) {
+            self.setInstanceCount(count);
+        }, "Instance count")
+        .def("draw", [](GL::MeshView& self, GL::AbstractShaderProgram& shader) {
+            checkMeshNotUploading(self.mesh());
+            self.draw(shader);
+            statsDraw();
+        }, "Draw the mesh view")
+        .def_static("draw_many", [](GL::AbstractShaderProgram& shader, const std::vector<std::reference_wrapper<GL::MeshView>>& views) {
+            if(views.empty()) return;
+
+            /* Checking what Magnum would assert on */
+            for(GL::MeshView& view: views) {
+                if(&view.mesh() != &views.front().get().mesh())
+                    throw py::value_error{"all views have to be of the same mesh"};
+                if(view.instanceCount() != 1)
+                    throw py::value_error{"can't multi-draw instanced views"};
+            }
+            checkMeshNotUploading(views.front().get().mesh());
+            GL::MeshView::draw(shader, Containers::arrayView(views));
+            statsDraw(views.size());
+        }, "Draw multiple mesh views at once", py::arg("shader"), py::arg("views"))
+
+        .def_property_readonly("mesh", [](GL::MeshView& self) {
+            return pyObjectHolderFor<GL::PyMeshViewHolder>(self).mesh;
+        }, "Original mesh");
+
+    /* Transform feedback */
+    #ifndef MAGNUM_TARGET_GLES2
+    {
+        py::class_<GL::TransformFeedback, GL::PyTransformFeedbackHolder<GL::TransformFeedback>> transformFeedback{m, "TransformFeedback", "Transform feedback"};
+
+        py::enum_<GL::TransformFeedback::PrimitiveMode>{transformFeedback, "PrimitiveMode", "Transform feedback primitive mode"}
+            .value("POINTS", GL::TransformFeedback::PrimitiveMode::Points)
+            .value("LINES", GL::TransformFeedback::PrimitiveMode::Lines)
+            .value("TRIANGLES", GL::TransformFeedback::PrimitiveMode::Triangles);
+
+        transformFeedback
+            .def(py::init(), "Constructor")
+            .def_property_readonly("id", &GL::TransformFeedback::id, "OpenGL transform feedback ID")
+            /* Using lambdas to avoid method chaining getting into signatures */
+            .def("attach_buffer", [](GL::TransformFeedback& self, UnsignedInt index, GL::Buffer& buffer, GLintptr offset, GLsizeiptr size) {
+                if(size) self.attachBuffer(index, buffer, offset, size);
+                else self.attachBuffer(index, buffer);
+
+                /* Keep a reference to the buffer to avoid it being deleted
+                   before the transform feedback */
+                pyObjectHolderFor<GL::PyTransformFeedbackHolder>(self).buffers.emplace_back(pyObjectFromInstance(buffer));
+            }, "Attach a buffer", py::arg("index"), py::arg("buffer"), py::arg("offset") = 0, py::arg("size") = 0)
+            .def("begin", &GL::TransformFeedback::begin,
+                "Begin transform feedback", py::arg("shader"), py::arg("mode"))
+            .def("pause", &GL::TransformFeedback::pause, "Pause transform feedback")
+            .def("resume", &GL::TransformFeedback::resume, "Resume transform feedback")
+            .def("end", &GL::TransformFeedback::end, "End transform feedback")
+
+            .def_property_readonly("buffers", [](GL::TransformFeedback& self) {
+                return pyObjectHolderFor<GL::PyTransformFeedbackHolder>(self).buffers;
+            }, "Buffer objects referenced by the transform feedback");
+    }
+    #endif
+
+    /* Queries */
+    #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+    PyNonDestructibleClass<GL::AbstractQuery>{m,
+        "AbstractQuery", "Base class for queries"}
+        .def_property_readonly("id", &GL::AbstractQuery::id, "OpenGL query ID")
+        .def_property_readonly("result_available", &GL::AbstractQuery::resultAvailable,
+            "Whether the result is available")
+        .def("begin", [](GL::AbstractQuery& self) {
+            self.begin();
+        }, "Begin query")
+        .def("end", &GL::AbstractQuery::end, "End query");
+    #endif
+
+    #ifndef MAGNUM_TARGET_WEBGL
+    {
+        PyNonDestructibleClass<GL::TimeQuery, GL::AbstractQuery> timeQuery{m,
+            "TimeQuery", "Query for elapsed time"};
+
+        py::enum_<GL::TimeQuery::Target>{timeQuery, "Target", "Query target"}
+            .value("TIME_ELAPSED", GL::TimeQuery::Target::TimeElapsed)
+            .value("TIMESTAMP", GL::TimeQuery::Target::Timestamp);
+
+        timeQuery
+            .def(py::init<GL::TimeQuery::Target>(), "Constructor", py::arg("target") = GL::TimeQuery::Target::TimeElapsed)
+            .def("timestamp", &GL::TimeQuery::timestamp, "Query timestamp")
+            .def_property_readonly("result", [](GL::TimeQuery& self) {
+                return self.result<UnsignedLong>();
+            }, "Result in nanoseconds");
+    }
+    #endif
+
+    #ifndef MAGNUM_TARGET_GLES2
+    {
+        PyNonDestructibleClass<GL::PrimitiveQuery, GL::AbstractQuery> primitiveQuery{m,
+            "PrimitiveQuery", "Query for primitives"};
+
+        py::enum_<GL::PrimitiveQuery::Target>{primitiveQuery, "Target", "Query target"}
+            #ifndef MAGNUM_TARGET_WEBGL
+            .value("PRIMITIVES_GENERATED", GL::PrimitiveQuery::Target::PrimitivesGenerated)
+            #endif
+            .value("TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN", GL::PrimitiveQuery::Target::TransformFeedbackPrimitivesWritten);
+
+        primitiveQuery
+            .def(py::init<GL::PrimitiveQuery::Target>(), "Constructor", py::arg("target"))
+            .def_property_readonly("result", [](GL::PrimitiveQuery& self) {
+                return self.result<UnsignedInt>();
+            }, "Result");
+    }
+    #endif
+
+    #if !(defined(MAGNUM_TARGET_WEBGL) && defined(MAGNUM_TARGET_GLES2))
+    {
+        PyNonDestructibleClass<GL::SampleQuery, GL::AbstractQuery> sampleQuery{m,
+            "SampleQuery", "Query for samples"};
+
+        py::enum_<GL::SampleQuery::Target>{sampleQuery, "Target", "Query target"}
+            #ifndef MAGNUM_TARGET_GLES
+            .value("SAMPLES_PASSED", GL::SampleQuery::Target::SamplesPassed)
+            #endif
+            .value("ANY_SAMPLES_PASSED", GL::SampleQuery::Target::AnySamplesPassed)
+            .value("ANY_SAMPLES_PASSED_CONSERVATIVE", GL::SampleQuery::Target::AnySamplesPassedConservative);
+
+        #ifndef MAGNUM_TARGET_GLES
+        py::enum_<GL::SampleQuery::ConditionalRenderMode>{sampleQuery, "ConditionalRenderMode", "Conditional render mode"}
+            .value("WAIT", GL::SampleQuery::ConditionalRenderMode::Wait)
+            .value("NO_WAIT", GL::SampleQuery::ConditionalRenderMode::NoWait)
+            .value("BY_REGION_WAIT", GL::SampleQuery::ConditionalRenderMode::ByRegionWait)
+            .value("BY_REGION_NO_WAIT", GL::SampleQuery::ConditionalRenderMode::ByRegionNoWait);
+        #endif
+
+        sampleQuery
+            .def(py::init<GL::SampleQuery::Target>(), "Constructor", py::arg("target"))
+            .def_property_readonly("result", [](GL::SampleQuery& self) {
+                return self.result<UnsignedInt>();
+            }, "Result")
+            #ifndef MAGNUM_TARGET_GLES
+            .def("begin_conditional_render", &GL::SampleQuery::beginConditionalRender,
+                "Begin conditional rendering based on result value", py::arg("mode"))
+            .def("end_conditional_render", &GL::SampleQuery::endConditionalRender,
+                "End conditional render")
+            #endif
+            ;
+    }
+    #endif
+
+    #ifndef MAGNUM_TARGET_GLES2
+    py::class_<OcclusionCuller>{m, "OcclusionCuller", "Occlusion culling for a group of drawables"}
+        .def(py::init(), "Constructor")
+        .def("draw", &OcclusionCuller::draw,
+            "Draw visible drawables and query occlusion of their bounding boxes", py::arg("drawables"), py::arg("camera"))
+        .def_property_readonly("drawn_count", &OcclusionCuller::drawnCount,
+            "Count of drawables drawn in the last draw")
+        .def_property_readonly("culled_count", &OcclusionCuller::culledCount,
+            "Count of drawables culled in the last draw");
+    #endif
+
+    #ifndef MAGNUM_TARGET_WEBGL
+    {
+        py::class_<FrameProfiler> frameProfiler{m, "FrameProfiler", "CPU and GPU frame profiler"};
+
+        py::class_<FrameProfilerScope>{frameProfiler, "Scope", "Profiled scope"}
+            .def("__enter__", [](FrameProfilerScope& self) {
+                self.profiler.begin(self.name);
+            }, "Begin the section")
+            .def("__exit__", [](FrameProfilerScope& self, py::args) {
+                self.profiler.end();
+            }, "End the section");
+
+        frameProfiler
+            .def(py::init<std::size_t>(), "Constructor", py::arg("max_frames") = 60)
+            .def_property_readonly("max_frames", &FrameProfiler::maxFrames,
+                "Max count of frames kept")
+            .def("begin_frame", &FrameProfiler::beginFrame, "Begin a frame")
+            .def("end_frame", &FrameProfiler::endFrame, "End a frame")
+            .def("begin", &FrameProfiler::begin, "Begin a section", py::arg("name"))
+            .def("end", &FrameProfiler::end, "End a section")
+            .def("scope", [](FrameProfiler& self, std::string name) {
+                return FrameProfilerScope{self, std::move(name)};
+            }, "Profile a scope", py::arg("name"), py::keep_alive<0, 1>())
+            .def_property_readonly("records", [](FrameProfiler& self) {
+                py::list out;
+                for(const FrameProfiler::Record& record: self.records())
+                    out.append(py::make_tuple(record.frame, record.name, record.depth, record.cpuBegin, record.cpuDuration, record.gpuBegin, record.gpuDuration));
+                return out;
+            }, "Recorded sections")
+            .def("trace_json", &FrameProfiler::traceJson,
+                "Recorded sections in the Trace Event Format");
+    }
+    #endif
+
     /* Renderer */
     {
         py::class_<GL::Renderer> renderer{m, "Renderer", "Global renderer configuration"};
@@ -478,17 +2360,92 @@ void gl(py::module& m) {
             .value("SCISSOR_TEST", GL::Renderer::Feature::ScissorTest)
             .value("STENCIL_TEST", GL::Renderer::Feature::StencilTest);
 
+        #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+        py::enum_<GL::Renderer::MemoryBarrier> memoryBarrier{renderer, "MemoryBarrier", "Memory barrier"};
+        memoryBarrier
+            .value("VERTEX_ATTRIBUTE_ARRAY", GL::Renderer::MemoryBarrier::VertexAttributeArray)
+            .value("ELEMENT_ARRAY", GL::Renderer::MemoryBarrier::ElementArray)
+            .value("UNIFORM", GL::Renderer::MemoryBarrier::Uniform)
+            .value("TEXTURE_FETCH", GL::Renderer::MemoryBarrier::TextureFetch)
+            .value("SHADER_IMAGE_ACCESS", GL::Renderer::MemoryBarrier::ShaderImageAccess)
+            .value("COMMAND", GL::Renderer::MemoryBarrier::Command)
+            .value("PIXEL_BUFFER", GL::Renderer::MemoryBarrier::PixelBuffer)
+            .value("TEXTURE_UPDATE", GL::Renderer::MemoryBarrier::TextureUpdate)
+            .value("BUFFER_UPDATE", GL::Renderer::MemoryBarrier::BufferUpdate)
+            .value("FRAMEBUFFER", GL::Renderer::MemoryBarrier::Framebuffer)
+            .value("TRANSFORM_FEEDBACK", GL::Renderer::MemoryBarrier::TransformFeedback)
+            .value("ATOMIC_COUNTER", GL::Renderer::MemoryBarrier::AtomicCounter)
+            .value("SHADER_STORAGE", GL::Renderer::MemoryBarrier::ShaderStorage);
+        corrade::enumOperators(memoryBarrier);
+        #endif
+
         renderer
-            .def_static("enable", GL::Renderer::enable, "Enable a feature")
-            .def_static("disable", GL::Renderer::disable, "Disable a feature")
-            .def_static("set_feature", GL::Renderer::setFeature, "Enable or disable a feature")
+            .def_static("enable", [](GL::Renderer::Feature feature) {
+                rendererSetFeature(feature, true);
+            }, "Enable a feature")
+            .def_static("disable", [](GL::Renderer::Feature feature) {
+                rendererSetFeature(feature, false);
+            }, "Disable a feature")
+            .def_static("set_feature", [](GL::Renderer::Feature feature, bool enabled) {
+                rendererSetFeature(feature, enabled);
+            }, "Enable or disable a feature")
+            .def_static("apply", [](const py::dict& features) {
+                for(const auto& item: features) {
+                    if(!py::isinstance<GL::Renderer::Feature>(item.first))
+                        throw py::type_error{Utility::formatString("expected Renderer.Feature, got {}", std::string(py::str{item.first.get_type()}))};
+                    bool enabled;
+                    try {
+                        enabled = py::cast<bool>(item.second);
+                    } catch(const py::cast_error&) {
+                        throw py::type_error{Utility::formatString("expected bool, got {}", std::string(py::str{item.second.get_type()}))};
+                    }
+                    rendererSetFeature(py::cast<GL::Renderer::Feature>(item.first), enabled);
+                }
+            }, "Enable or disable multiple features", py::arg("features"))
+            .def_static("reset_state_cache", []() {
+                RendererState& state = rendererState();
+                state.features.clear();
+                state.clearColor = Containers::NullOpt;
+            }, "Reset the renderer state cache")
+            #if !defined(MAGNUM_TARGET_GLES2) && !defined(MAGNUM_TARGET_WEBGL)
+            .def_static("set_memory_barrier", [](GL::Renderer::MemoryBarrier barriers) {
+                GL::Renderer::setMemoryBarrier(barriers);
+            }, "Set memory barrier", py::arg("barriers"))
+            #endif
 
             .def_property_static("clear_color", nullptr,
                 [](py::object, const Color4& color) {
                     /** @todo why can't it be just a single param? */
-                    GL::Renderer::setClearColor(color);
+                    rendererSetClearColor(color);
                 }, "Set clear color");
     }
+
+    /* Statistics */
+    m
+        .def("enable_stats", [](bool enabled) {
+            Stats& s = stats();
+            /* Whatever was tracked before could have changed in the meantime
+               without us knowing */
+            if(enabled && !s.enabled) s.staticBuffers.clear();
+            s.enabled = enabled;
+        }, "Enable or disable statistics collection", py::arg("enabled") = true)
+        .def("stats", []() {
+            const Stats::Counters& c = stats().counters;
+            py::dict out;
+            out["draw_calls"] = c.drawCalls;
+            out["uploads"] = c.uploads;
+            out["bytes_uploaded"] = c.bytesUploaded;
+            out["downloads"] = c.downloads;
+            out["bytes_downloaded"] = c.bytesDownloaded;
+            out["static_reuploads"] = c.staticReuploads;
+            out["framebuffer_binds"] = c.framebufferBinds;
+            out["state_changes"] = c.stateChanges;
+            out["redundant_state_changes"] = c.redundantStateChanges;
+            return out;
+        }, "Statistics collected since the last reset")
+        .def("reset_stats", []() {
+            stats().counters = {};
+        }, "Reset statistics");
 }
 
 }
@@ -23,18 +23,26 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <limits>
+#include <tuple>
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
+#include <Corrade/Containers/Array.h>
 #include <Corrade/Containers/StridedArrayView.h>
 #include <Magnum/ImageView.h>
 #include <Magnum/Mesh.h>
 #include <Magnum/PixelFormat.h>
 #include <Magnum/PixelStorage.h>
+#include <Magnum/Math/Constants.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Packing.h>
 
 #include "Corrade/Python.h"
 #include "Corrade/Containers/Python.h"
 #include "Magnum/Python.h"
 
+#include "corrade/ContentHash.h"
 #include "magnum/bootstrap.h"
 
 #ifdef MAGNUM_BUILD_STATIC
@@ -59,6 +67,107 @@ template<class T> struct PyDimensionTraits<3, T> {
     static VectorType from(const Math::Vector<3, T>& vec) { return vec; }
 };
 
+/* Half-floats are unpacked to / packed from 32-bit floats on access */
+const Containers::PyArrayViewFormat HalfFormat{"e", 2,
+    [](const char* item) -> py::object {
+        UnsignedShort value;
+        std::memcpy(&value, item, 2);
+        return py::cast(Math::unpackHalf(value));
+    },
+    [](char* item, py::handle value) {
+        const UnsignedShort data = Math::packHalf(py::cast<Float>(value));
+        std::memcpy(item, &data, 2);
+    }
+};
+
+/* Type and count of pixel channels */
+struct PixelFormatChannels {
+    const Containers::PyArrayViewFormat* format;
+    UnsignedInt count;
+};
+
+PixelFormatChannels pixelFormatChannels(const PixelFormat format) {
+    /* Implementation-specific formats have no known channel layout */
+    if(isPixelFormatImplementationSpecific(format)) return {};
+
+    switch(format) {
+        #define _c(format, type, count) \
+            case PixelFormat::format: return {&Containers::pyArrayViewFormat<type>(), count};
+        _c(R8Unorm, UnsignedByte, 1)
+        _c(RG8Unorm, UnsignedByte, 2)
+        _c(RGB8Unorm, UnsignedByte, 3)
+        _c(RGBA8Unorm, UnsignedByte, 4)
+        _c(R8Snorm, Byte, 1)
+        _c(RG8Snorm, Byte, 2)
+        _c(RGB8Snorm, Byte, 3)
+        _c(RGBA8Snorm, Byte, 4)
+        _c(R8UI, UnsignedByte, 1)
+        _c(RG8UI, UnsignedByte, 2)
+        _c(RGB8UI, UnsignedByte, 3)
+        _c(RGBA8UI, UnsignedByte, 4)
+        _c(R8I, Byte, 1)
+        _c(RG8I, Byte, 2)
+        _c(RGB8I, Byte, 3)
+        _c(RGBA8I, Byte, 4)
+        _c(R16Unorm, UnsignedShort, 1)
+        _c(RG16Unorm, UnsignedShort, 2)
+        _c(RGB16Unorm, UnsignedShort, 3)
+        _c(RGBA16Unorm, UnsignedShort, 4)
+        _c(R16Snorm, Short, 1)
+        _c(RG16Snorm, Short, 2)
+        _c(RGB16Snorm, Short, 3)
+        _c(RGBA16Snorm, Short, 4)
+        _c(R16UI, UnsignedShort, 1)
+        _c(RG16UI, UnsignedShort, 2)
+        _c(RGB16UI, UnsignedShort, 3)
+        _c(RGBA16UI, UnsignedShort, 4)
+        _c(R16I, Short, 1)
+        _c(RG16I, Short, 2)
+        _c(RGB16I, Short, 3)
+        _c(RGBA16I, Short, 4)
+        _c(R32UI, UnsignedInt, 1)
+        _c(RG32UI, UnsignedInt, 2)
+        _c(RGB32UI, UnsignedInt, 3)
+        _c(RGBA32UI, UnsignedInt, 4)
+        _c(R32I, Int, 1)
+        _c(RG32I, Int, 2)
+        _c(RGB32I, Int, 3)
+        _c(RGBA32I, Int, 4)
+        _c(R32F, Float, 1)
+        _c(RG32F, Float, 2)
+        _c(RGB32F, Float, 3)
+        _c(RGBA32F, Float, 4)
+        #undef _c
+        case PixelFormat::R16F: return {&HalfFormat, 1};
+        case PixelFormat::RG16F: return {&HalfFormat, 2};
+        case PixelFormat::RGB16F: return {&HalfFormat, 3};
+        case PixelFormat::RGBA16F: return {&HalfFormat, 4};
+    }
+
+    return {};
+}
+
+/* Pixel view with the last dimension being channels of the type matching the
+   pixel format. For unknown formats the last dimension is pixel bytes. */
+template<class T> Containers::PyArrayViewHolder<Containers::StridedArrayView<T::Dimensions + 1, typename T::Type>> pixels(T& self) {
+    const Containers::StridedArrayView<T::Dimensions + 1, typename T::Type> view = self.pixels();
+    const py::object& owner = pyObjectHolderFor<PyImageViewHolder>(self).owner;
+
+    const PixelFormatChannels channels = pixelFormatChannels(self.format());
+    if(!channels.format || !view.data())
+        return Containers::pyArrayViewHolder(view, owner);
+
+    Containers::StridedDimensions<T::Dimensions + 1, std::size_t> size = view.size();
+    Containers::StridedDimensions<T::Dimensions + 1, std::ptrdiff_t> stride = view.stride();
+    size[T::Dimensions] = channels.count;
+    stride[T::Dimensions] = channels.format->itemsize;
+
+    /* The pixel view starts after the skipped data, the memory span goes
+       until the end of the image data */
+    const std::size_t dataSize = self.data().size() - (static_cast<const char*>(view.data()) - self.data().data());
+    return Containers::pyArrayViewHolder(Containers::StridedArrayView<T::Dimensions + 1, typename T::Type>{{view.data(), dataSize}, size, stride}, owner, channels.format);
+}
+
 template<class T> void imageView(py::class_<T, PyImageViewHolder<T>>& c) {
     /*
         Missing APIs:
@@ -95,15 +204,67 @@ template<class T> void imageView(py::class_<T, PyImageViewHolder<T>>& c) {
             pyObjectHolderFor<PyImageViewHolder>(self).owner =
             pyObjectHolderFor<Containers::PyArrayViewHolder>(data).owner;
         }, "Image data")
-        .def_property_readonly("pixels", [](T& self) {
-            return Containers::pyArrayViewHolder(self.pixels(), pyObjectHolderFor<PyImageViewHolder>(self).owner);
-        }, "View on pixel data")
+        .def_property_readonly("pixels", pixels<T>, "View on pixel data")
+        .def("hash", [](T& self) {
+            /* Padding and skipped data are not a part of the pixel view, so
+               they don't affect the result */
+            const Containers::StridedArrayView<T::Dimensions + 1, const char> pixels = self.pixels();
+            py::gil_scoped_release release;
+            return corrade::contentHash(pixels, 1);
+        }, "Hash of the pixel data")
 
         .def_property_readonly("owner", [](T& self) {
             return pyObjectHolderFor<PyImageViewHolder>(self).owner;
         }, "Memory owner");
 }
 
+/* A view on a part of the image. References the same data, only the skip
+   and row length / image height are adjusted to describe the subrange. */
+template<class T> T subImageView(const T& self, const Math::Vector<T::Dimensions, Int>& offset, const Math::Vector<T::Dimensions, Int>& size) {
+    PixelStorage storage = self.storage();
+    storage.setSkip(storage.skip() + Vector3i::pad(offset));
+    if(!storage.rowLength()) storage.setRowLength(self.size()[0]);
+    if(T::Dimensions > 2 && !storage.imageHeight())
+        storage.setImageHeight(self.size()[1]);
+    return T{storage, self.format(), size, self.data()};
+}
+
+template<class T> void imageViewTiles(py::class_<T, PyImageViewHolder<T>>& c) {
+    c
+        .def("tiles", [](T& self, const typename PyDimensionTraits<T::Dimensions, Int>::VectorType& size, const typename PyDimensionTraits<T::Dimensions, Int>::VectorType& overlap) {
+            const Math::Vector<T::Dimensions, Int> tileSize = size;
+            const Math::Vector<T::Dimensions, Int> tileOverlap = overlap;
+            if(!(tileSize > Math::Vector<T::Dimensions, Int>{0}).all())
+                throw py::value_error{"tile size has to be positive"};
+            if(!(tileOverlap >= Math::Vector<T::Dimensions, Int>{0}).all() || !(tileOverlap < tileSize).all())
+                throw py::value_error{"tile overlap has to be non-negative and smaller than tile size"};
+
+            py::list out;
+            const Math::Vector<T::Dimensions, Int> imageSize = self.size();
+            if(!(imageSize > Math::Vector<T::Dimensions, Int>{0}).all())
+                return out;
+
+            /* Go in the memory order, X first. A next tile in given dimension
+               is needed only if the previous didn't reach the edge. */
+            const Math::Vector<T::Dimensions, Int> step = tileSize - tileOverlap;
+            const py::object& owner = pyObjectHolderFor<PyImageViewHolder>(self).owner;
+            Math::Vector<T::Dimensions, Int> offset;
+            for(;;) {
+                out.append(pyCastButNotShitty(pyImageViewHolder(subImageView(self, offset, Math::min(tileSize, imageSize - offset)), owner)));
+
+                std::size_t i = 0;
+                for(; i != T::Dimensions; ++i) {
+                    offset[i] += step[i];
+                    if(offset[i] + tileOverlap[i] < imageSize[i]) break;
+                    offset[i] = 0;
+                }
+                if(i == T::Dimensions) break;
+            }
+
+            return out;
+        }, "Split the image into tiles", py::arg("size"), py::arg("overlap") = typename PyDimensionTraits<T::Dimensions, Int>::VectorType{});
+}
+
 template<class T> void imageViewFromMutable(py::class_<T, PyImageViewHolder<T>>& c) {
     c
         .def(py::init([](const BasicMutableImageView<T::Dimensions>& other) {
@@ -111,7 +272,289 @@ template<class T> void imageViewFromMutable(py::class_<T, PyImageViewHolder<T>>&
         }), "Constructor");
 }
 
+/* Channel value conversion for image processing. Half-floats are marked with
+   a dedicated type to distinguish them from UnsignedShort. */
+struct HalfChannel { UnsignedShort value; };
+template<class T> struct ChannelTraits {
+    static Double value(const char* data) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return Double(value);
+    }
+};
+template<> struct ChannelTraits<HalfChannel> {
+    static Double value(const char* data) {
+        UnsignedShort value;
+        std::memcpy(&value, data, sizeof(UnsignedShort));
+        return Double(Math::unpackHalf(value));
+    }
+};
+
+/* Calls Kernel<T>::run() with T being the channel type of given format */
+template<template<class> class Kernel, class ...Args> void dispatchChannelType(const Containers::PyArrayViewFormat& format, Args&&... args) {
+    switch(format.format[0]) {
+        #define _c(format, type) \
+            case format: Kernel<type>::run(std::forward<Args>(args)...); return;
+        _c('B', UnsignedByte)
+        _c('b', Byte)
+        _c('H', UnsignedShort)
+        _c('h', Short)
+        _c('I', UnsignedInt)
+        _c('i', Int)
+        _c('e', HalfChannel)
+        _c('f', Float)
+        #undef _c
+    }
+
+    CORRADE_ASSERT_UNREACHABLE(); /* LCOV_EXCL_LINE */
+}
+
+/* Channels of a format that image processing functions can work with */
+PixelFormatChannels processablePixelFormatChannels(const PixelFormat format) {
+    const PixelFormatChannels channels = pixelFormatChannels(format);
+    if(!channels.format)
+        throw py::value_error{"unsupported pixel format"};
+    return channels;
+}
+
+/* Calls given function with each 2D slice of the image pixels */
+template<class F> void forEachPixelSlice(const Containers::StridedArrayView3D<const char>& pixels, F f) {
+    f(pixels);
+}
+template<class F> void forEachPixelSlice(const Containers::StridedArrayView4D<const char>& pixels, F f) {
+    for(const Containers::StridedArrayView3D<const char> slice: pixels)
+        f(slice);
+}
+
+struct ImageDelta {
+    Float max;
+    Double sum;
+    std::size_t count;
+    std::size_t outliers;
+};
+
+/* Per-pixel delta is a difference averaged over all channels, same as in
+   DebugTools::CompareImage. Deltas that are NaN are counted as outliers and
+   not included in max and mean. */
+template<class T> struct ImageDeltaKernel {
+    static void run(const Containers::StridedArrayView3D<const char>& a, const Containers::StridedArrayView3D<const char>& b, const UnsignedInt channelCount, const Float threshold, const Containers::StridedArrayView3D<char>& delta, ImageDelta& out) {
+        for(std::size_t y = 0, height = a.size()[0]; y != height; ++y) {
+            for(std::size_t x = 0, width = a.size()[1]; x != width; ++x) {
+                const char* pixelA = &a[y][x][0];
+                const char* pixelB = &b[y][x][0];
+                Float pixelDelta = 0.0f;
+                for(std::size_t c = 0; c != channelCount; ++c)
+                    pixelDelta += Float(Math::abs(ChannelTraits<T>::value(pixelA + c*sizeof(T)) - ChannelTraits<T>::value(pixelB + c*sizeof(T))));
+                pixelDelta /= channelCount;
+
+                if(delta.data())
+                    std::memcpy(&delta[y][x][0], &pixelDelta, sizeof(Float));
+
+                if(pixelDelta != pixelDelta) {
+                    ++out.outliers;
+                    continue;
+                }
+
+                if(pixelDelta > threshold) ++out.outliers;
+                out.max = Math::max(out.max, pixelDelta);
+                out.sum += pixelDelta;
+                ++out.count;
+            }
+        }
+    }
+};
+
+std::tuple<Float, Float, std::size_t> compareImages(const ImageView2D& a, const ImageView2D& b, const Float threshold, const MutableImageView2D* const deltaImage) {
+    if(a.format() != b.format())
+        throw py::value_error{"image formats are different"};
+    if(a.size() != b.size())
+        throw py::value_error{"image sizes are different"};
+    const PixelFormatChannels channels = processablePixelFormatChannels(a.format());
+
+    /* The delta image is optional */
+    Containers::StridedArrayView3D<char> delta;
+    if(deltaImage) {
+        if(deltaImage->format() != PixelFormat::R32F || deltaImage->size() != a.size())
+            throw py::value_error{"expected a R32F delta image of the same size"};
+        delta = deltaImage->pixels();
+    }
+
+    ImageDelta out{};
+    {
+        /* No Python APIs are touched from now on, so other threads can
+           compare images in the meantime */
+        py::gil_scoped_release release;
+        dispatchChannelType<ImageDeltaKernel>(*channels.format, a.pixels(), b.pixels(), channels.count, threshold, delta, out);
+    }
+
+    return std::make_tuple(out.max, out.count ? Float(out.sum/out.count) : 0.0f, out.outliers);
+}
+
+/* NaNs fail all comparisons and thus are skipped */
+template<class T> struct MinMaxKernel {
+    static void run(const Containers::StridedArrayView3D<const char>& pixels, const UnsignedInt channelCount, Double* const min, Double* const max) {
+        for(const Containers::StridedArrayView2D<const char> row: pixels) {
+            for(const Containers::StridedArrayView1D<const char> pixel: row) {
+                for(std::size_t c = 0; c != channelCount; ++c) {
+                    const Double value = ChannelTraits<T>::value(&pixel[c*sizeof(T)]);
+                    if(value < min[c]) min[c] = value;
+                    if(value > max[c]) max[c] = value;
+                }
+            }
+        }
+    }
+};
+
+template<class T> struct SumKernel {
+    static void run(const Containers::StridedArrayView3D<const char>& pixels, const UnsignedInt channelCount, Double* const sum) {
+        for(const Containers::StridedArrayView2D<const char> row: pixels)
+            for(const Containers::StridedArrayView1D<const char> pixel: row)
+                for(std::size_t c = 0; c != channelCount; ++c)
+                    sum[c] += ChannelTraits<T>::value(&pixel[c*sizeof(T)]);
+    }
+};
+
+/* Bins are half-open except for the last one, which includes the range end
+   as well. Values outside of the range and NaNs are not counted. */
+template<class T> struct HistogramKernel {
+    static void run(const Containers::StridedArrayView3D<const char>& pixels, const UnsignedInt channelCount, const Double min, const Double max, const std::size_t bins, std::size_t* const counts) {
+        const Double scale = bins/(max - min);
+        for(const Containers::StridedArrayView2D<const char> row: pixels) {
+            for(const Containers::StridedArrayView1D<const char> pixel: row) {
+                for(std::size_t c = 0; c != channelCount; ++c) {
+                    const Double value = ChannelTraits<T>::value(&pixel[c*sizeof(T)]);
+                    if(!(value >= min && value <= max)) continue;
+                    const std::size_t bin = std::size_t((value - min)*scale);
+                    ++counts[c*bins + (bin < bins ? bin : bins - 1)];
+                }
+            }
+        }
+    }
+};
+
+/* Integer types have the whole value range by default, with each value
+   having its own bin if the bin count matches. Floating-point types have no
+   default range. */
+template<class T> struct HistogramRangeKernel {
+    static void run(bool& defined, Double& min, Double& max) {
+        defined = std::is_integral<T>::value;
+        min = Double(std::numeric_limits<T>::lowest());
+        max = Double(std::numeric_limits<T>::max()) + 1.0;
+    }
+};
+template<> struct HistogramRangeKernel<HalfChannel> {
+    static void run(bool& defined, Double&, Double&) { defined = false; }
+};
+
+py::tuple channelTuple(const Containers::ArrayView<const Double> values) {
+    py::tuple out{values.size()};
+    for(std::size_t i = 0; i != values.size(); ++i)
+        out[i] = py::float_{values[i]};
+    return out;
+}
+
+template<class T> std::pair<Containers::Array<Double>, Containers::Array<Double>> imageMinMax(const T& self, const PixelFormatChannels& channels) {
+    if(!self.size().product())
+        throw py::value_error{"the image is empty"};
+
+    Containers::Array<Double> min{Containers::DirectInit, channels.count, Constantsd::inf()};
+    Containers::Array<Double> max{Containers::DirectInit, channels.count, -Constantsd::inf()};
+    {
+        py::gil_scoped_release release;
+        forEachPixelSlice(self.pixels(), [&](const Containers::StridedArrayView3D<const char>& slice) {
+            dispatchChannelType<MinMaxKernel>(*channels.format, slice, channels.count, min.data(), max.data());
+        });
+    }
+
+    return {std::move(min), std::move(max)};
+}
+
+template<class T> void imageViewStatistics(py::class_<T, PyImageViewHolder<T>>& c) {
+    c
+        .def("minmax", [](T& self) {
+            const std::pair<Containers::Array<Double>, Containers::Array<Double>> minmax = imageMinMax(self, processablePixelFormatChannels(self.format()));
+            return py::make_tuple(channelTuple(minmax.first), channelTuple(minmax.second));
+        }, "Per-channel minimum and maximum")
+        .def("mean", [](T& self) {
+            const PixelFormatChannels channels = processablePixelFormatChannels(self.format());
+            const std::size_t count = self.size().product();
+            if(!count) throw py::value_error{"the image is empty"};
+
+            Containers::Array<Double> sum{Containers::ValueInit, channels.count};
+            {
+                py::gil_scoped_release release;
+                forEachPixelSlice(self.pixels(), [&](const Containers::StridedArrayView3D<const char>& slice) {
+                    dispatchChannelType<SumKernel>(*channels.format, slice, channels.count, sum.data());
+                });
+            }
+
+            for(Double& i: sum) i /= count;
+            return channelTuple(sum);
+        }, "Per-channel mean")
+        .def("histogram", [](T& self, const std::size_t bins, const py::object& range) {
+            const PixelFormatChannels channels = processablePixelFormatChannels(self.format());
+            if(!bins) throw py::value_error{"expected a non-zero bin count"};
+
+            /* If range is not specified, use the type range for integer
+               formats and data range for floating-point formats */
+            Double min, max;
+            if(!range.is_none()) {
+                std::tie(min, max) = py::cast<std::pair<Double, Double>>(range);
+                if(!(min < max)) throw py::value_error{"expected a non-empty range"};
+            } else {
+                bool defined;
+                dispatchChannelType<HistogramRangeKernel>(*channels.format, defined, min, max);
+                if(!defined) {
+                    const std::pair<Containers::Array<Double>, Containers::Array<Double>> minmax = imageMinMax(self, channels);
+                    min = *std::min_element(minmax.first.begin(), minmax.first.end());
+                    max = *std::max_element(minmax.second.begin(), minmax.second.end());
+                    /* All values are NaN or the same, make a non-empty range
+                       so there's a place to put them */
+                    if(!(min < max)) {
+                        if(min != min) min = 0.0;
+                        max = min + 1.0;
+                    }
+                }
+            }
+
+            Containers::Array<std::size_t> counts{Containers::ValueInit, channels.count*bins};
+            {
+                py::gil_scoped_release release;
+                forEachPixelSlice(self.pixels(), [&](const Containers::StridedArrayView3D<const char>& slice) {
+                    dispatchChannelType<HistogramKernel>(*channels.format, slice, channels.count, min, max, bins, counts.data());
+                });
+            }
+
+            py::list out;
+            for(std::size_t c = 0; c != channels.count; ++c) {
+                py::list channel;
+                for(std::size_t i = 0; i != bins; ++i)
+                    channel.append(counts[c*bins + i]);
+                out.append(channel);
+            }
+            return out;
+        }, "Per-channel histogram", py::arg("bins") = 256, py::arg("range") = py::none{});
+}
+
 void magnum(py::module& m) {
+    /* Build-time configuration, so code (and tests) can tell the targets
+       apart without probing for names that are compiled out */
+    #ifdef MAGNUM_TARGET_GLES
+    m.attr("TARGET_GLES") = true;
+    #else
+    m.attr("TARGET_GLES") = false;
+    #endif
+    #ifdef MAGNUM_TARGET_GLES2
+    m.attr("TARGET_GLES2") = true;
+    #else
+    m.attr("TARGET_GLES2") = false;
+    #endif
+    #ifdef MAGNUM_TARGET_WEBGL
+    m.attr("TARGET_WEBGL") = true;
+    #else
+    m.attr("TARGET_WEBGL") = false;
+    #endif
+
     py::enum_<MeshPrimitive>{m, "MeshPrimitive", "Mesh primitive type"}
         .value("POINTS", MeshPrimitive::Points)
         .value("LINES", MeshPrimitive::Lines)
@@ -207,9 +650,21 @@ void magnum(py::module& m) {
     imageView(mutableImageView2D);
     imageView(mutableImageView3D);
 
+    imageViewTiles(imageView2D);
+    imageViewTiles(imageView3D);
+    imageViewTiles(mutableImageView2D);
+    imageViewTiles(mutableImageView3D);
+
+    imageViewStatistics(imageView2D);
+    imageViewStatistics(imageView3D);
+    imageViewStatistics(mutableImageView2D);
+    imageViewStatistics(mutableImageView3D);
+
     imageViewFromMutable(imageView1D);
     imageViewFromMutable(imageView2D);
     imageViewFromMutable(imageView3D);
+
+    m.def("compare_images", compareImages, "Compare two images", py::arg("a"), py::arg("b"), py::arg("threshold") = 0.0f, py::arg("delta") = py::none{});
 }
 
 }}
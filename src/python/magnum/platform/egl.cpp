@@ -26,6 +26,8 @@
 #include <pybind11/pybind11.h>
 #include <Magnum/Platform/WindowlessEglApplication.h>
 
+#include "Magnum/GL/Python.h"
+
 #include "magnum/bootstrap.h"
 #include "magnum/platform/windowlessapplication.h"
 
@@ -39,7 +41,9 @@ void egl(py::module& m) {
     m.doc() = "EGL-based platform integration";
 
     struct PyWindowlessApplication: Platform::WindowlessApplication {
-        explicit PyWindowlessApplication(const Configuration& configuration = Configuration{}): Platform::WindowlessApplication{Arguments{argc, nullptr}, configuration} {}
+        explicit PyWindowlessApplication(const Configuration& configuration = Configuration{}): Platform::WindowlessApplication{Arguments{argc, nullptr}, configuration} {
+            ++GL::pyContextGeneration();
+        }
 
         int exec() override {
             #ifdef __clang__
@@ -26,6 +26,8 @@
 #include <pybind11/pybind11.h>
 #include <Magnum/Platform/GlfwApplication.h>
 
+#include "Magnum/GL/Python.h"
+
 #include "magnum/bootstrap.h"
 #include "magnum/platform/application.h"
 
@@ -39,7 +41,9 @@ void glfw(py::module& m) {
     m.doc() = "GLFW-based platform integration";
 
     struct PublicizedApplication: Platform::Application {
-        explicit PublicizedApplication(const Configuration& configuration, const GLConfiguration& glConfiguration): Platform::Application{Arguments{argc, nullptr}, configuration, glConfiguration} {}
+        explicit PublicizedApplication(const Configuration& configuration, const GLConfiguration& glConfiguration): Platform::Application{Arguments{argc, nullptr}, configuration, glConfiguration} {
+            ++GL::pyContextGeneration();
+        }
 
         void drawEvent() override {}
         void mousePressEvent(MouseEvent&) override {}
@@ -23,21 +23,148 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <cstring>
+#include <functional>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> /* for vector arguments */
-#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Containers/Optional.h>
+#include <Corrade/Utility/FormatStl.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/Texture.h>
 #include <Magnum/Shaders/Phong.h>
 #include <Magnum/Shaders/VertexColor.h>
 
 #include "Magnum/Python.h"
+#include "Magnum/GL/Python.h"
 
 #include "corrade/EnumOperators.h"
+#include "magnum/arrayviewcaster.h"
 #include "magnum/bootstrap.h"
 
 namespace magnum {
 
 namespace {
 
+/* Per-draw data for draw_many(), passed as a float buffer of shape
+   (count, rows[, cols]) -- such as a field of a numpy structured array.
+   The elements are read through the strides, so the data don't need to be
+   contiguous and both row-major and column-major matrices work. */
+class PerDrawData {
+    public:
+        /* Vectors have cols set to 0 */
+        explicit PerDrawData(const py::handle& object, const std::size_t rows, const std::size_t cols, const char* name) {
+            Py_buffer& buffer = _buffer.buffer;
+            if(PyObject_GetBuffer(object.ptr(), &buffer, PyBUF_FORMAT|PyBUF_STRIDES) != 0)
+                throw py::error_already_set{};
+
+            /* The buffer gets released by the member destructor if any of
+               these throws */
+            if(buffer.ndim != (cols ? 3 : 2))
+                throw py::buffer_error{Utility::formatString("expected {} dimensions for {} but got {}", cols ? 3 : 2, name, buffer.ndim)};
+            if(cols && (std::size_t(buffer.shape[1]) != rows || std::size_t(buffer.shape[2]) != cols))
+                throw py::buffer_error{Utility::formatString("expected {}x{} elements for {} but got {}x{}", cols, rows, name, buffer.shape[2], buffer.shape[1])};
+            if(!cols && std::size_t(buffer.shape[1]) != rows)
+                throw py::buffer_error{Utility::formatString("expected {} elements for {} but got {}", rows, name, buffer.shape[1])};
+
+            /* Expecting just an one-letter format */
+            if(buffer.format[0] != 'f' || buffer.format[1])
+                throw py::buffer_error{Utility::formatString("expected format f for {} but got {}", name, buffer.format)};
+        }
+
+        std::size_t size() const { return _buffer.buffer.shape[0]; }
+
+        template<class T> T matrix(const std::size_t i) const {
+            T out{Math::NoInit};
+            for(std::size_t col = 0; col != T::Cols; ++col)
+                for(std::size_t row = 0; row != T::Rows; ++row)
+                    out[col][row] = get(i, row, col);
+            return out;
+        }
+
+        template<class T> T vector(const std::size_t i) const {
+            T out{Math::NoInit};
+            for(std::size_t row = 0; row != T::Size; ++row)
+                out[row] = get(i, row, 0);
+            return out;
+        }
+
+    private:
+        Float get(const std::size_t i, const std::size_t row, const std::size_t col) const {
+            const Py_buffer& buffer = _buffer.buffer;
+            /* The strides don't need to be a multiple of the float size */
+            Float out;
+            std::memcpy(&out, static_cast<const char*>(buffer.buf) + i*buffer.strides[0] + row*buffer.strides[1] + (col ? col*buffer.strides[2] : 0), sizeof(Float));
+            return out;
+        }
+
+        struct Buffer {
+            Buffer() = default;
+            Buffer(const Buffer&) = delete;
+            Buffer& operator=(const Buffer&) = delete;
+            /* No-op if the buffer wasn't acquired */
+            ~Buffer() { PyBuffer_Release(&buffer); }
+
+            Py_buffer buffer{};
+        } _buffer;
+};
+
+void checkPerDrawDataSize(const PerDrawData& data, const std::size_t count, const char* name) {
+    if(data.size() != count)
+        throw py::value_error{Utility::formatString("expected {} {} but got {}", count, name, data.size())};
+}
+
+/* Checks all meshes the same way as Mesh.draw() does, before anything gets
+   drawn */
+void checkDrawMeshes(const std::vector<std::reference_wrapper<GL::Mesh>>& meshes) {
+    void(*const check)(GL::Mesh&) = GL::pyMeshDrawHooks().check;
+    if(check) for(GL::Mesh& mesh: meshes) check(mesh);
+}
+
+/* Counts the draws in gl.stats() */
+void countDraws(const std::size_t count) {
+    void(*const hook)(std::size_t) = GL::pyMeshDrawHooks().count;
+    if(hook) hook(count);
+}
+
+template<UnsignedInt dimensions> void vertexColorDrawMany(Shaders::VertexColor<dimensions>& self, const std::vector<std::reference_wrapper<GL::Mesh>>& meshes, const py::object& transformationProjectionMatrices) {
+    const PerDrawData transformationProjection{transformationProjectionMatrices, dimensions + 1, dimensions + 1, "transformation projection matrices"};
+    const std::size_t count = meshes.size();
+    checkPerDrawDataSize(transformationProjection, count, "transformation projection matrices");
+    checkDrawMeshes(meshes);
+
+    for(std::size_t i = 0; i != count; ++i) {
+        self.setTransformationProjectionMatrix(transformationProjection.matrix<MatrixTypeFor<dimensions, Float>>(i));
+        meshes[i].get().draw(self);
+    }
+    countDraws(count);
+}
+
+void phongDrawMany(Shaders::Phong& self, const std::vector<std::reference_wrapper<GL::Mesh>>& meshes, const py::object& transformationMatrices, const py::object& normalMatrices, const py::object& diffuseColors) {
+    const PerDrawData transformation{transformationMatrices, 4, 4, "transformation matrices"};
+    const std::size_t count = meshes.size();
+    checkPerDrawDataSize(transformation, count, "transformation matrices");
+    Containers::Optional<PerDrawData> normal;
+    if(!normalMatrices.is_none()) {
+        normal.emplace(normalMatrices, 3, 3, "normal matrices");
+        checkPerDrawDataSize(*normal, count, "normal matrices");
+    }
+    Containers::Optional<PerDrawData> diffuse;
+    if(!diffuseColors.is_none()) {
+        diffuse.emplace(diffuseColors, 4, 0, "diffuse colors");
+        checkPerDrawDataSize(*diffuse, count, "diffuse colors");
+    }
+    checkDrawMeshes(meshes);
+
+    for(std::size_t i = 0; i != count; ++i) {
+        const Matrix4 transformationMatrix = transformation.matrix<Matrix4>(i);
+        self.setTransformationMatrix(transformationMatrix)
+            .setNormalMatrix(normal ? normal->matrix<Matrix3x3>(i) : transformationMatrix.rotationScaling().inverted().transposed());
+        if(diffuse) self.setDiffuseColor(diffuse->vector<Color4>(i));
+        meshes[i].get().draw(self);
+    }
+    countDraws(count);
+}
+
 template<UnsignedInt dimensions> void vertexColor(PyNonDestructibleClass<Shaders::VertexColor<dimensions>, GL::AbstractShaderProgram>& c) {
     /* Attributes */
     c.attr("COLOR3") = GL::DynamicAttribute{
@@ -56,7 +183,10 @@ template<UnsignedInt dimensions> void vertexColor(PyNonDestructibleClass<Shaders
         /* Using lambdas to avoid method chaining getting into signatures */
 
         .def_property("transformation_projection_matrix", nullptr, &Shaders::VertexColor<dimensions>::setTransformationProjectionMatrix,
-            "Transformation and projection matrix");
+            "Transformation and projection matrix")
+        .def("draw_many", [](Shaders::VertexColor<dimensions>& self, const std::vector<std::reference_wrapper<GL::Mesh>>& meshes, const py::object& transformationProjectionMatrices) {
+            vertexColorDrawMany(self, meshes, transformationProjectionMatrices);
+        }, "Draw multiple meshes with per-draw data", py::arg("meshes"), py::arg("transformation_projection_matrices"));
 }
 
 }
@@ -130,7 +260,21 @@ void shaders(py::module& m) {
                 &Shaders::Phong::setDiffuseColor, "Diffuse color")
             .def_property("specular_color", nullptr,
                 &Shaders::Phong::setSpecularColor, "Specular color")
-            // TODO: textures, once exposed
+            .def("bind_ambient_texture", [](Shaders::Phong& self, GL::Texture2D& texture) {
+                if(!(self.flags() & Shaders::Phong::Flag::AmbientTexture))
+                    throw py::value_error{"the shader was not created with ambient texture enabled"};
+                self.bindAmbientTexture(texture);
+            }, "Bind an ambient texture", py::arg("texture"))
+            .def("bind_diffuse_texture", [](Shaders::Phong& self, GL::Texture2D& texture) {
+                if(!(self.flags() & Shaders::Phong::Flag::DiffuseTexture))
+                    throw py::value_error{"the shader was not created with diffuse texture enabled"};
+                self.bindDiffuseTexture(texture);
+            }, "Bind a diffuse texture", py::arg("texture"))
+            .def("bind_specular_texture", [](Shaders::Phong& self, GL::Texture2D& texture) {
+                if(!(self.flags() & Shaders::Phong::Flag::SpecularTexture))
+                    throw py::value_error{"the shader was not created with specular texture enabled"};
+                self.bindSpecularTexture(texture);
+            }, "Bind a specular texture", py::arg("texture"))
             .def_property("shininess", nullptr,
                 &Shaders::Phong::setShininess, "Shininess")
             .def_property("alpha_mask", nullptr,
@@ -141,12 +285,19 @@ void shaders(py::module& m) {
                 &Shaders::Phong::setNormalMatrix, "Set normal matrix")
             .def_property("projection_matrix", nullptr,
                 &Shaders::Phong::setProjectionMatrix, "Set projection matrix")
-            .def_property("light_positions", nullptr, [](Shaders::Phong& self, const std::vector<Vector3>& positions) {
+            .def_property("light_positions", nullptr, [](Shaders::Phong& self, const Containers::ArrayView<const Vector3>& positions) {
+                if(positions.size() != self.lightCount())
+                    throw py::value_error{Utility::formatString("expected {} light positions but got {}", self.lightCount(), positions.size())};
                 self.setLightPositions(positions);
             }, "Light positions")
-            .def_property("light_colors", nullptr, [](Shaders::Phong& self, const std::vector<Color4>& colors) {
+            .def_property("light_colors", nullptr, [](Shaders::Phong& self, const Containers::ArrayView<const Color4>& colors) {
+                if(colors.size() != self.lightCount())
+                    throw py::value_error{Utility::formatString("expected {} light colors but got {}", self.lightCount(), colors.size())};
                 self.setLightColors(colors);
-            }, "Light colors");
+            }, "Light colors")
+            .def("draw_many", [](Shaders::Phong& self, const std::vector<std::reference_wrapper<GL::Mesh>>& meshes, const py::object& transformationMatrices, const py::object& normalMatrices, const py::object& diffuseColors) {
+                phongDrawMany(self, meshes, transformationMatrices, normalMatrices, diffuseColors);
+            }, "Draw multiple meshes with per-draw data", py::arg("meshes"), py::arg("transformation_matrices"), py::arg("normal_matrices") = py::none{}, py::arg("diffuse_colors") = py::none{});
     }
 }
 
@@ -23,9 +23,11 @@
 #   DEALINGS IN THE SOFTWARE.
 #
 
+import array
 import sys
 import unittest
 
+from corrade import containers
 from magnum import *
 
 class PixelStorage_(unittest.TestCase):
@@ -66,11 +68,11 @@ class ImageView(unittest.TestCase):
         self.assertEqual(sys.getrefcount(data), data_refcount + 1)
 
         # Third row, second pixel, green channel
-        self.assertEqual(a.pixels[2][1][1], 'E')
+        self.assertEqual(a.pixels[2][1][1], ord('E'))
 
         # Deleting the original data shouldn't make the image invalid
         del data
-        self.assertEqual(a.pixels[2][1][1], 'E')
+        self.assertEqual(a.pixels[2][1][1], ord('E'))
 
     def test_init_storage(self):
         # 2x2x2 RGB pixels
@@ -88,7 +90,7 @@ class ImageView(unittest.TestCase):
         self.assertEqual(len(a.data), 24)
 
         # Second image, first row, second pixel, green channel
-        self.assertEqual(a.pixels[1][0][1][1], 'E')
+        self.assertEqual(a.pixels[1][0][1][1], ord('E'))
 
     def test_init_empty(self):
         a = MutableImageView1D(PixelFormat.RG16UI, 32)
@@ -116,10 +118,10 @@ class ImageView(unittest.TestCase):
         a = MutableImageView2D(PixelFormat.RGB8UNORM, (2, 4), data)
         self.assertEqual(sys.getrefcount(data), data_refcount + 1)
 
-        a.pixels[1, 1, 1] = '_'
-        a.pixels[1, 0, 1] = '_'
-        a.pixels[2, 1, 1] = '_'
-        a.pixels[2, 0, 1] = '_'
+        a.pixels[1, 1, 1] = ord('_')
+        a.pixels[1, 0, 1] = ord('_')
+        a.pixels[2, 1, 1] = ord('_')
+        a.pixels[2, 0, 1] = ord('_')
 
         self.assertEqual(data, b'rgbRGB  '
                                b'a_cA_C  '
@@ -135,6 +137,107 @@ class ImageView(unittest.TestCase):
         self.assertIs(b.owner, data)
         self.assertEqual(sys.getrefcount(data), data_refcount + 2)
 
+    def test_pixels_typed(self):
+        # 2x2 RGB32F pixels
+        data = array.array('f', [0.0, 0.5, 1.0, 1.5, 2.0, 2.5,
+                                 3.0, 3.5, 4.0, 4.5, 5.0, 5.5])
+
+        a = ImageView2D(PixelFormat.RGB32F, (2, 2), data)
+        self.assertEqual(a.pixels.size, (2, 2, 3))
+        self.assertEqual(a.pixels.stride, (24, 12, 4))
+        self.assertEqual(a.pixels[1, 0, 2], 4.0)
+        self.assertEqual(a.pixels[0][1][1], 2.0)
+
+        view = memoryview(a.pixels)
+        self.assertEqual(view.format, 'f')
+        self.assertEqual(view.itemsize, 4)
+        self.assertEqual(view.shape, (2, 2, 3))
+
+        # Slicing keeps the type
+        self.assertEqual(memoryview(a.pixels[1:]).format, 'f')
+        self.assertEqual(bytes(a.pixels[1][0]), bytes(data)[24:36])
+
+    def test_pixels_typed_mutable(self):
+        # 3x1 R16UI pixels, padded for alignment
+        data = array.array('H', [1, 2, 3, 0])
+
+        a = MutableImageView2D(PixelFormat.R16UI, (3, 1), data)
+        self.assertEqual(a.pixels.size, (1, 3, 1))
+        self.assertEqual(memoryview(a.pixels).format, 'H')
+
+        a.pixels[0, 2, 0] = 65535
+        self.assertEqual(data[2], 65535)
+
+        with self.assertRaisesRegex(TypeError, "can't assign <class 'str'> to a view item"):
+            a.pixels[0, 2, 0] = 'a'
+
+    def test_pixels_half(self):
+        # 2x1 R16F pixels, 1.0 and -2.0
+        data = array.array('H', [0x3c00, 0xc000])
+
+        a = MutableImageView2D(PixelFormat.R16F, (2, 1), data)
+        self.assertEqual(memoryview(a.pixels).format, 'e')
+        self.assertEqual(a.pixels[0, 0, 0], 1.0)
+        self.assertEqual(a.pixels[0, 1, 0], -2.0)
+
+        a.pixels[0, 0, 0] = 0.5
+        self.assertEqual(data[0], 0x3800)
+
+    def test_tiles(self):
+        # 5x3 R8 pixels, padded for alignment
+        data = (b'abcde   '
+                b'fghij   '
+                b'klmno   ')
+        data_refcount = sys.getrefcount(data)
+
+        a = ImageView2D(PixelFormat.R8UNORM, (5, 3), data)
+        tiles = a.tiles((2, 2))
+        self.assertEqual(len(tiles), 6)
+        self.assertEqual([i.size for i in tiles], [
+            Vector2i(2, 2), Vector2i(2, 2), Vector2i(1, 2),
+            Vector2i(2, 1), Vector2i(2, 1), Vector2i(1, 1)])
+
+        # The tiles reference the original data
+        self.assertIs(tiles[4].owner, data)
+        self.assertEqual(sys.getrefcount(data), data_refcount + 7)
+        self.assertEqual(tiles[1].pixels[1, 0, 0], ord('h'))
+        self.assertEqual(tiles[4].pixels[0, 1, 0], ord('n'))
+
+    def test_tiles_overlap(self):
+        a = ImageView3D(PixelFormat.RGBA8UNORM, (5, 3, 2), bytearray(5*3*2*4))
+        tiles = a.tiles((2, 2, 2), overlap=(1, 1, 0))
+        self.assertEqual(len(tiles), 8)
+        self.assertEqual(tiles[3].size, Vector3i(2, 2, 2))
+        self.assertEqual(tiles[7].size, Vector3i(2, 2, 2))
+
+    def test_tiles_invalid(self):
+        a = ImageView2D(PixelFormat.R8UNORM, (5, 3), b'\0'*24)
+        with self.assertRaisesRegex(ValueError, "tile size has to be positive"):
+            a.tiles((0, 2))
+        with self.assertRaisesRegex(ValueError, "tile overlap has to be non-negative and smaller than tile size"):
+            a.tiles((2, 2), (2, 0))
+
+    def test_hash(self):
+        # 2x4 RGB pixels, padded for alignment
+        a = ImageView2D(PixelFormat.RGB8UNORM, (2, 4), b'rgbRGB  '
+                                                       b'abcABC  '
+                                                       b'defDEF  '
+                                                       b'ijkIJK  ')
+        # Same pixels, different padding
+        b = ImageView2D(PixelFormat.RGB8UNORM, (2, 4), b'rgbRGB__'
+                                                       b'abcABC__'
+                                                       b'defDEF__'
+                                                       b'ijkIJK__')
+        self.assertEqual(a.hash(), b.hash())
+        self.assertEqual(a.hash(), containers.ArrayView(bytes(a.pixels)).hash())
+
+        # Different pixel data
+        c = ImageView2D(PixelFormat.RGB8UNORM, (2, 4), b'rgbRGB  '
+                                                       b'abcABC  '
+                                                       b'defDEF  '
+                                                       b'ijkIJk  ')
+        self.assertNotEqual(a.hash(), c.hash())
+
     def test_set_data(self):
         # 2x4 RGB pixels, padded for alignment
         data = (b'rgbRGB  '
@@ -164,3 +267,76 @@ class ImageView(unittest.TestCase):
         self.assertIs(a.owner, data2)
         self.assertEqual(sys.getrefcount(data), data_refcount)
         self.assertEqual(sys.getrefcount(data2), data_refcount + 1)
+
+class ImageStatistics(unittest.TestCase):
+    def test_minmax_mean(self):
+        # 2x2 RG8 pixels
+        a = ImageView2D(PixelFormat.RG8UI, (2, 2), b'\x00\x10\x20\x30'
+                                                   b'\x40\x50\x60\xff')
+        self.assertEqual(a.minmax(), ((0.0, 16.0), (96.0, 255.0)))
+        self.assertEqual(a.mean(), (48.0, 99.75))
+
+    def test_minmax_mean_3d(self):
+        a = MutableImageView3D(PixelFormat.R32F, (1, 1, 3), array.array('f', [2.0, -1.5, 0.5]))
+        self.assertEqual(a.minmax(), ((-1.5, ), (2.0, )))
+        self.assertEqual(a.mean(), (1.0/3.0, ))
+
+    def test_histogram(self):
+        a = ImageView2D(PixelFormat.RG8UNORM, (2, 2), b'\x00\x10\x20\x30'
+                                                      b'\x40\x50\xff\x30')
+        self.assertEqual(a.histogram(4), [[2, 1, 0, 1], [3, 1, 0, 0]])
+        self.assertEqual(a.histogram(2, range=(0, 64)), [[1, 2], [1, 2]])
+        self.assertEqual(len(a.histogram()[0]), 256)
+        self.assertEqual(a.histogram()[1][0x30], 2)
+
+    def test_histogram_float(self):
+        a = ImageView2D(PixelFormat.R32F, (4, 1), array.array('f', [0.0, 1.0, 0.25, 0.5]))
+        # Range is derived from data, the last bin includes the end
+        self.assertEqual(a.histogram(2), [[2, 2]])
+
+    def test_invalid(self):
+        a = ImageView2D(PixelFormat.R8UNORM, (4, 1), b'abcd')
+        with self.assertRaisesRegex(ValueError, "expected a non-zero bin count"):
+            a.histogram(0)
+        with self.assertRaisesRegex(ValueError, "expected a non-empty range"):
+            a.histogram(4, (1.0, 1.0))
+
+        b = ImageView2D(PixelFormat.R8UNORM, (0, 4))
+        with self.assertRaisesRegex(ValueError, "the image is empty"):
+            b.mean()
+
+class CompareImages(unittest.TestCase):
+    def test(self):
+        a = ImageView2D(PixelFormat.RG8UNORM, (2, 2), b'\x00\x10\x20\x30'
+                                                      b'\x40\x50\x60\x70')
+        b = ImageView2D(PixelFormat.RG8UNORM, (2, 2), b'\x00\x10\x22\x30'
+                                                      b'\x40\x50\x50\x60')
+
+        max, mean, outliers = compare_images(a, b, threshold=2.0)
+        self.assertEqual(max, 16.0)
+        self.assertEqual(mean, 4.25)
+        self.assertEqual(outliers, 1)
+
+    def test_delta(self):
+        a = ImageView2D(PixelFormat.R32F, (2, 1), array.array('f', [1.0, 0.25]))
+        b = ImageView2D(PixelFormat.R32F, (2, 1), array.array('f', [0.5, 0.25]))
+
+        data = array.array('f', [0.0, 0.0])
+        delta = MutableImageView2D(PixelFormat.R32F, (2, 1), data)
+        self.assertEqual(compare_images(a, b, delta=delta), (0.5, 0.25, 1))
+        self.assertEqual(list(data), [0.5, 0.0])
+
+    def test_invalid(self):
+        a = ImageView2D(PixelFormat.R8UNORM, (4, 1), b'abcd')
+        b = ImageView2D(PixelFormat.RGBA8UNORM, (1, 1), b'abcd')
+        c = ImageView2D(PixelFormat.R8UNORM, (2, 2), b'abcdabcd')
+        delta = MutableImageView2D(PixelFormat.RG16F, (4, 1), bytearray(16))
+
+        with self.assertRaisesRegex(ValueError, "image formats are different"):
+            compare_images(a, b)
+        with self.assertRaisesRegex(ValueError, "image sizes are different"):
+            compare_images(a, c)
+        with self.assertRaisesRegex(ValueError, "expected a R32F delta image of the same size"):
+            compare_images(a, a, delta=delta)
+        with self.assertRaisesRegex(TypeError, "incompatible function arguments"):
+            compare_images(a, a, delta=bytearray(16))
@@ -25,14 +25,28 @@
 
 import array
 import sys
+import tempfile
 import unittest
 
 # setUpModule gets called before everything else, skipping if GL tests can't
 # be run
 from . import GLTestCase, setUpModule
 
+from corrade import containers
 from magnum import *
-from magnum import gl
+from magnum import gl, shaders
+
+# Some functionality is compiled in on ES2 but depends on extensions that may
+# not be available, such as on the SwiftShader-based CI
+gles2 = TARGET_GLES2
+gles = TARGET_GLES
+
+# Custom shaders in the tests are written for GLSL 3.30, which GLSL ES 3.00
+# matches closely enough except for the required default float precision in
+# fragment shaders. GLSL ES 1.00 is too different, so these tests are skipped
+# on ES2.
+glsl_version = gl.Version.GLES300 if gles else gl.Version.GL330
+glsl_fragment_precision = 'precision mediump float;\n' if gles else ''
 
 class Buffer(GLTestCase):
     def test_init(self):
@@ -52,6 +66,401 @@ class Buffer(GLTestCase):
         a = gl.Buffer()
         a.set_data(array.array('f', [0.5, 1.2]))
 
+    @unittest.skipUnless(hasattr(gl.Buffer, 'sub_data'), "buffer readback not available")
+    def test_set_sub_data(self):
+        a = gl.Buffer()
+        a.set_data(b'hello world', gl.BufferUsage.DYNAMIC_DRAW)
+        a.set_sub_data(6, b'WORLD')
+
+        self.assertEqual(bytes(a.sub_data(0, 11)), b'hello WORLD')
+
+    def test_set_sub_data_invalid(self):
+        a = gl.Buffer()
+        with self.assertRaisesRegex(ValueError, "offset -1 is negative"):
+            a.set_sub_data(-1, b'hello')
+
+    def test_data(self):
+        a = gl.Buffer()
+        a.set_data(b'hello world', gl.BufferUsage.DYNAMIC_READ)
+        self.assertEqual(a.size, 11)
+        self.assertEqual(a.data(), b'hello world')
+        self.assertIsInstance(a.sub_data(6, 5), bytearray)
+        self.assertEqual(a.sub_data(6, 5), b'world')
+        self.assertEqual(a.sub_data(6, 0), b'')
+
+    def test_sub_data_into(self):
+        a = gl.Buffer()
+        a.set_data(array.array('f', [0.5, 1.25, 2.0]), gl.BufferUsage.DYNAMIC_READ)
+
+        out = array.array('f', [0.0, 0.0])
+        a.sub_data(4, out)
+        self.assertEqual(out.tolist(), [1.25, 2.0])
+
+        with self.assertRaisesRegex(TypeError, "incompatible function arguments"):
+            a.sub_data(0, b'immutable')
+
+    def test_sub_data_invalid(self):
+        a = gl.Buffer()
+        with self.assertRaisesRegex(ValueError, "can't read 5 bytes at offset -1"):
+            a.sub_data(-1, 5)
+        with self.assertRaisesRegex(ValueError, "can't read -5 bytes at offset 0"):
+            a.sub_data(0, -5)
+        with self.assertRaisesRegex(ValueError, "can't read 2 bytes at offset -1"):
+            a.sub_data(-1, bytearray(2))
+        if hasattr(gl.Buffer, 'sub_data_async'):
+            with self.assertRaisesRegex(ValueError, "can't read 5 bytes at offset -1"):
+                a.sub_data_async(-1, 5)
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'set_data_async'), "async upload not available")
+    def test_set_data_async(self):
+        a = gl.Buffer()
+        upload = a.set_data_async(b'hello world', gl.BufferUsage.STATIC_DRAW)
+        self.assertEqual(a.size, 11)
+        self.assertTrue(upload.wait())
+        self.assertEqual(a.sub_data(0, 11), b'hello world')
+
+        # Polling after the wait is a no-op
+        self.assertTrue(upload.poll())
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'set_data_async'), "async upload not available")
+    def test_set_data_async_in_progress(self):
+        a = gl.Buffer()
+        upload = a.set_data_async(b'hello world')
+        with self.assertRaisesRegex(RuntimeError, "buffer has an async upload in progress"):
+            a.set_sub_data(0, b'HELLO')
+        with self.assertRaisesRegex(RuntimeError, "buffer has an async upload in progress"):
+            a.set_data_async(b'HELLO')
+
+        # Meshes using the buffer can't be drawn either
+        mesh = gl.Mesh()
+        mesh.count = 1
+        mesh.add_vertex_buffer(a, 0, 8, gl.Attribute(gl.Attribute.Kind.GENERIC, 2, gl.Attribute.Components.TWO, gl.Attribute.DataType.FLOAT))
+        with self.assertRaisesRegex(RuntimeError, "mesh references a buffer with an async upload in progress"):
+            mesh.draw(shaders.VertexColor2D())
+
+        # Finishing the upload makes the buffer usable again
+        self.assertTrue(upload.wait())
+        a.set_sub_data(0, b'HELLO')
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'set_data_async'), "async upload not available")
+    def test_set_data_async_empty(self):
+        a = gl.Buffer()
+        upload = a.set_data_async(b'')
+        self.assertTrue(upload.poll())
+        self.assertEqual(a.size, 0)
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'sub_data_async'), "async read not available")
+    def test_sub_data_async(self):
+        a = gl.Buffer()
+        a.set_data(b'hello world', gl.BufferUsage.DYNAMIC_DRAW)
+
+        read = a.sub_data_async(6, 5)
+        b = read.wait()
+        self.assertIsInstance(b, containers.ArrayView)
+        self.assertEqual(bytes(b), b'world')
+        self.assertIs(b.owner, read)
+
+        # Polling after the wait returns the same data
+        self.assertEqual(bytes(read.poll()), b'world')
+
+        # The view keeps the read and thus the mapping alive
+        del read
+        self.assertEqual(bytes(b), b'world')
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'map') and not gles2, "buffer mapping not available")
+    def test_map(self):
+        a = gl.Buffer()
+        a.set_data(b'hello world', gl.BufferUsage.DYNAMIC_DRAW)
+        a_refcount = sys.getrefcount(a)
+
+        b = a.map(6, 5, gl.Buffer.MapFlag.WRITE|gl.Buffer.MapFlag.INVALIDATE_RANGE)
+        self.assertIsInstance(b, containers.MutableArrayView)
+        self.assertEqual(len(b), 5)
+        self.assertIs(b.owner, a)
+        self.assertEqual(sys.getrefcount(a), a_refcount + 1)
+
+        memoryview(b)[:] = b'WORLD'
+        self.assertTrue(a.unmap())
+
+        c = a.map(0, 11, gl.Buffer.MapFlag.READ)
+        self.assertEqual(bytes(c), b'hello WORLD')
+        self.assertTrue(a.unmap())
+
+        # Deleting the view should release the buffer reference
+        del b, c
+        self.assertEqual(sys.getrefcount(a), a_refcount)
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'map') and not gles2, "buffer mapping not available")
+    def test_map_flush_explicit(self):
+        a = gl.Buffer()
+        a.set_data(b'hello world', gl.BufferUsage.DYNAMIC_DRAW)
+
+        b = a.map(0, 11, gl.Buffer.MapFlag.WRITE|gl.Buffer.MapFlag.FLUSH_EXPLICIT)
+        memoryview(b)[0:5] = b'HELLO'
+        a.flush_mapped_range(0, 5)
+        self.assertTrue(a.unmap())
+
+        c = a.map(0, 11, gl.Buffer.MapFlag.READ)
+        self.assertEqual(bytes(c)[0:5], b'HELLO')
+        self.assertTrue(a.unmap())
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'map') and not gles2, "buffer mapping not available")
+    def test_map_invalid(self):
+        a = gl.Buffer()
+        with self.assertRaisesRegex(ValueError, "can't map 5 bytes at offset -1"):
+            a.map(-1, 5)
+
+@unittest.skipIf(gles2, "GLSL ES 1.00 not supported by the tests")
+class Shader(GLTestCase):
+    def test(self):
+        a = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+        self.assertNotEqual(a.id, 0)
+        self.assertEqual(a.type, gl.Shader.Type.VERTEX)
+        a.add_source('void main() { gl_Position = vec4(0.0); }\n')
+        self.assertEqual(a.sources[-1], 'void main() { gl_Position = vec4(0.0); }\n')
+        self.assertTrue(a.compile())
+
+    def test_compile_failed(self):
+        a = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+        a.add_source('this is not a shader\n')
+        self.assertFalse(a.compile())
+
+    def test_add_file_nonexistent(self):
+        a = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+        with self.assertRaisesRegex(FileNotFoundError, "file nonexistent.glsl does not exist"):
+            a.add_file('nonexistent.glsl')
+
+@unittest.skipIf(gles2, "GLSL ES 1.00 not supported by the tests")
+class ShaderProgram(GLTestCase):
+    def test(self):
+        vert = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+        vert.add_source("""
+in vec4 position;
+uniform mat4 transformation;
+void main() { gl_Position = transformation*position; }
+""")
+        frag = gl.Shader(glsl_version, gl.Shader.Type.FRAGMENT)
+        frag.add_source(glsl_fragment_precision + """
+uniform vec4 color;
+out vec4 fragmentColor;
+void main() { fragmentColor = color; }
+""")
+        self.assertTrue(vert.compile())
+        self.assertTrue(frag.compile())
+
+        a = gl.ShaderProgram()
+        self.assertNotEqual(a.id, 0)
+        a.attach_shader(vert)
+        a.attach_shader(frag)
+        a.bind_attribute_location(0, 'position')
+        self.assertTrue(a.link())
+
+        a.set_uniform(a.uniform_location('transformation'), Matrix4.translation(Vector3.x_axis()))
+        a.set_uniform(a.uniform_location('color'), Vector4(1.0, 0.5, 0.75, 1.0))
+        self.assertEqual(a.uniform_location('nonexistent'), -1)
+
+        # Usable for drawing like any other shader
+        mesh = gl.Mesh()
+        mesh.count = 0
+        mesh.draw(a)
+
+    @unittest.skipUnless(hasattr(gl, 'AsyncLink'), "async link not available")
+    def test_link_async(self):
+        vert = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+        vert.add_source("""
+in vec4 position;
+void main() { gl_Position = position; }
+""")
+        frag = gl.Shader(glsl_version, gl.Shader.Type.FRAGMENT)
+        frag.add_source(glsl_fragment_precision + """
+uniform vec4 color;
+out vec4 fragmentColor;
+void main() { fragmentColor = color; }
+""")
+
+        a = gl.ShaderProgram()
+        link = a.link_async([vert, frag])
+        while link.poll() is None: pass
+        self.assertTrue(link.poll())
+        self.assertTrue(link.wait())
+        self.assertNotEqual(a.uniform_location('color'), -1)
+
+    @unittest.skipUnless(hasattr(gl, 'AsyncLink'), "async link not available")
+    def test_link_async_failed(self):
+        vert = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+        vert.add_source("this is not GLSL")
+
+        a = gl.ShaderProgram()
+        self.assertFalse(a.link_async([vert]).wait())
+
+    @unittest.skipUnless(hasattr(gl, 'ProgramCache'), "program binaries not available")
+    def test_cache(self):
+        def shaders():
+            vert = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+            vert.add_source("""
+in vec4 position;
+void main() { gl_Position = position; }
+""")
+            frag = gl.Shader(glsl_version, gl.Shader.Type.FRAGMENT)
+            frag.add_source(glsl_fragment_precision + """
+uniform vec4 color;
+out vec4 fragmentColor;
+void main() { fragmentColor = color; }
+""")
+            return [vert, frag]
+
+        with tempfile.TemporaryDirectory() as directory:
+            cache = gl.ProgramCache(directory)
+            self.assertEqual(cache.directory, directory)
+            if not cache.supported:
+                self.skipTest("no program binary formats supported")
+
+            a = gl.ShaderProgram()
+            self.assertTrue(cache.link(a, shaders()))
+            self.assertEqual(cache.hits, 0)
+            self.assertEqual(cache.misses, 1)
+
+            # A second cache on the same directory loads the binary
+            cache2 = gl.ProgramCache(directory)
+            b = gl.ShaderProgram()
+            self.assertTrue(cache2.link(b, shaders()))
+            self.assertEqual(cache2.hits, 1)
+            self.assertEqual(cache2.misses, 0)
+            self.assertNotEqual(b.uniform_location('color'), -1)
+
+            # Different attribute locations are a different program
+            c = gl.ShaderProgram()
+            c.bind_attribute_location(1, 'position')
+            self.assertTrue(cache2.link(c, shaders()))
+            self.assertEqual(cache2.hits, 1)
+            self.assertEqual(cache2.misses, 1)
+
+    def test_compute(self):
+        if not hasattr(gl.Shader.Type, 'COMPUTE') or not hasattr(gl.Version, 'GL430'):
+            self.skipTest("compute shaders not available")
+
+        shader = gl.Shader(gl.Version.GL430, gl.Shader.Type.COMPUTE)
+        shader.add_source("""
+layout(local_size_x = 4) in;
+layout(std430, binding = 0) buffer Data { float data[]; };
+uniform float scale;
+void main() { data[gl_GlobalInvocationID.x] *= scale; }
+""")
+        self.assertTrue(shader.compile())
+
+        program = gl.ShaderProgram()
+        program.attach_shader(shader)
+        self.assertTrue(program.link())
+        program.set_uniform(program.uniform_location('scale'), 2.0)
+
+        buffer = gl.Buffer()
+        buffer.set_data(array.array('f', [1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0]), gl.BufferUsage.DYNAMIC_READ)
+        buffer.bind(gl.Buffer.Target.SHADER_STORAGE, 0)
+
+        program.dispatch_compute((2, 1, 1))
+        gl.Renderer.set_memory_barrier(gl.Renderer.MemoryBarrier.BUFFER_UPDATE)
+
+        out = array.array('f', [0.0]*8)
+        buffer.sub_data(0, out)
+        self.assertEqual(out.tolist(), [2.0, 4.0, 6.0, 8.0, 10.0, 12.0, 14.0, 16.0])
+
+@unittest.skipUnless(hasattr(gl, 'TransformFeedback'), "transform feedback not available")
+class TransformFeedback(GLTestCase):
+    def test(self):
+        vert = gl.Shader(glsl_version, gl.Shader.Type.VERTEX)
+        vert.add_source("""
+out float value;
+void main() {
+    value = float(gl_VertexID)*2.0;
+    gl_Position = vec4(0.0);
+}
+""")
+        # ES requires a fragment shader even if nothing gets rasterized
+        frag = gl.Shader(glsl_version, gl.Shader.Type.FRAGMENT)
+        frag.add_source(glsl_fragment_precision + """
+out vec4 fragmentColor;
+void main() { fragmentColor = vec4(0.0); }
+""")
+        self.assertTrue(vert.compile())
+        self.assertTrue(frag.compile())
+
+        program = gl.ShaderProgram()
+        program.attach_shader(vert)
+        program.attach_shader(frag)
+        program.set_transform_feedback_outputs(['value'], gl.ShaderProgram.TransformFeedbackBufferMode.INTERLEAVED_ATTRIBUTES)
+        self.assertTrue(program.link())
+
+        buffer = gl.Buffer()
+        buffer.set_data(bytearray(16), gl.BufferUsage.DYNAMIC_READ)
+        buffer_refcount = sys.getrefcount(buffer)
+
+        feedback = gl.TransformFeedback()
+        self.assertNotEqual(feedback.id, 0)
+        feedback.attach_buffer(0, buffer)
+        self.assertIs(feedback.buffers[0], buffer)
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount + 1)
+
+        mesh = gl.Mesh(gl.MeshPrimitive.POINTS)
+        mesh.count = 4
+
+        gl.Renderer.enable(gl.Renderer.Feature.RASTERIZER_DISCARD)
+        feedback.begin(program, gl.TransformFeedback.PrimitiveMode.POINTS)
+        mesh.draw(program)
+        feedback.end()
+        gl.Renderer.disable(gl.Renderer.Feature.RASTERIZER_DISCARD)
+
+        out = array.array('f', [0.0]*4)
+        buffer.sub_data(0, out)
+        self.assertEqual(out.tolist(), [0.0, 2.0, 4.0, 6.0])
+
+class StreamingBuffer(GLTestCase):
+    def test_init(self):
+        a = gl.StreamingBuffer(64)
+        self.assertNotEqual(a.buffer.id, 0)
+        self.assertEqual(a.buffer.target_hint, gl.Buffer.TargetHint.ARRAY)
+        self.assertEqual(a.capacity, 64)
+        self.assertEqual(a.offset, 0)
+
+    @unittest.skipUnless(hasattr(gl.Buffer, 'sub_data'), "buffer readback not available")
+    def test_allocate(self):
+        a = gl.StreamingBuffer(16)
+        self.assertEqual(a.allocate(b'hello'), 0)
+        self.assertEqual(a.allocate(b'world', alignment=4), 8)
+        self.assertEqual(a.offset, 13)
+        a.flush()
+
+        b = a.buffer.sub_data(0, 13)
+        self.assertEqual(bytes(b)[0:5], b'hello')
+        self.assertEqual(bytes(b)[8:13], b'world')
+
+        # Doesn't fit into the rest, wraps around
+        self.assertEqual(a.allocate(b'magnum'), 0)
+        a.flush()
+
+        self.assertEqual(bytes(a.buffer.sub_data(0, 6)), b'magnum')
+
+    def test_allocate_invalid(self):
+        a = gl.StreamingBuffer(16)
+        with self.assertRaisesRegex(ValueError, "alignment can't be zero"):
+            a.allocate(b'hello', alignment=0)
+        with self.assertRaisesRegex(ValueError, "can't allocate 17 bytes in a buffer of 16 bytes"):
+            a.allocate(b'a'*17)
+
+        a.allocate(b'hello world')
+        with self.assertRaisesRegex(ValueError, "can't allocate 6 bytes, only 5 left until the end of the buffer; flush\\(\\) first"):
+            a.allocate(b'magnum')
+
+    def test_mesh(self):
+        a = gl.StreamingBuffer(64)
+        offset = a.allocate(array.array('f', [0.5, 1.2]))
+
+        mesh = gl.Mesh()
+        mesh.add_vertex_buffer(a.buffer, offset, 8, gl.Attribute(gl.Attribute.Kind.GENERIC, 2, gl.Attribute.Components.TWO, gl.Attribute.DataType.FLOAT))
+        a.flush()
+
+        # The mesh should reference the buffer
+        self.assertIs(mesh.buffers[0], a.buffer)
+
 class DefaultFramebuffer(GLTestCase):
     def test(self):
         # Using it should not crash, leak or cause double-free issues
@@ -74,6 +483,17 @@ class Framebuffer(GLTestCase):
         self.assertIs(framebuffer.attachments[0], renderbuffer)
         self.assertEqual(sys.getrefcount(renderbuffer), renderbuffer_refcount + 1)
 
+    def test_attach_texture(self):
+        texture = gl.Texture2D()
+        texture.set_storage(1, gl.TextureFormat.RGBA8, (4, 4))
+        texture_refcount = sys.getrefcount(texture)
+
+        framebuffer = gl.Framebuffer(((0, 0), (4, 4)))
+        framebuffer.attach_texture(gl.Framebuffer.ColorAttachment(0), texture, 0)
+        self.assertEqual(len(framebuffer.attachments), 1)
+        self.assertIs(framebuffer.attachments[0], texture)
+        self.assertEqual(sys.getrefcount(texture), texture_refcount + 1)
+
     def test_read(self):
         renderbuffer = gl.Renderbuffer()
         renderbuffer.set_storage(gl.RenderbufferFormat.RGBA8, (4, 4))
@@ -87,9 +507,68 @@ class Framebuffer(GLTestCase):
         a = MutableImageView2D(PixelFormat.RGBA8UNORM, (2, 2), bytearray(16))
         framebuffer.read(Range2Di.from_size((1, 1), (2, 2)), a)
         self.assertEqual(a.size, Vector2i(2, 2))
-        self.assertEqual(ord(a.pixels[0, 0, 0]), 0xff)
-        self.assertEqual(ord(a.pixels[0, 1, 1]), 0x80)
-        self.assertEqual(ord(a.pixels[1, 0, 2]), 0xbf)
+        self.assertEqual(a.pixels[0, 0, 0], 0xff)
+        self.assertEqual(a.pixels[0, 1, 1], 0x80)
+        self.assertEqual(a.pixels[1, 0, 2], 0xbf)
+
+    def test_blit(self):
+        source_renderbuffer = gl.Renderbuffer()
+        source_renderbuffer.set_storage(gl.RenderbufferFormat.RGBA8, (4, 4))
+        source = gl.Framebuffer(((0, 0), (4, 4)))
+        source.attach_renderbuffer(gl.Framebuffer.ColorAttachment(0), source_renderbuffer)
+
+        destination_renderbuffer = gl.Renderbuffer()
+        destination_renderbuffer.set_storage(gl.RenderbufferFormat.RGBA8, (2, 2))
+        destination = gl.Framebuffer(((0, 0), (2, 2)))
+        destination.attach_renderbuffer(gl.Framebuffer.ColorAttachment(0), destination_renderbuffer)
+
+        gl.Renderer.clear_color = Color4(1.0, 0.5, 0.75)
+        source.clear(gl.FramebufferClear.COLOR)
+
+        # Downscaled copy
+        gl.AbstractFramebuffer.blit(source, destination, ((0, 0), (4, 4)), ((0, 0), (2, 2)), gl.FramebufferBlit.COLOR, gl.FramebufferBlitFilter.LINEAR)
+
+        a = MutableImageView2D(PixelFormat.RGBA8UNORM, (2, 2), bytearray(16))
+        destination.read(((0, 0), (2, 2)), a)
+        self.assertEqual(a.pixels[1, 1, 0], 0xff)
+        self.assertEqual(a.pixels[1, 1, 1], 0x80)
+        self.assertEqual(a.pixels[1, 1, 2], 0xbf)
+
+        # Same-size copy
+        gl.Renderer.clear_color = Color4(0.0, 0.0, 1.0)
+        source.clear(gl.FramebufferClear.COLOR)
+        gl.AbstractFramebuffer.blit(source, destination, ((0, 0), (2, 2)), gl.FramebufferBlit.COLOR)
+        destination.read(((0, 0), (2, 2)), a)
+        self.assertEqual(a.pixels[0, 0, 0], 0)
+        self.assertEqual(a.pixels[0, 0, 2], 0xff)
+
+    @unittest.skipUnless(hasattr(gl.AbstractFramebuffer, 'read_async'), "async read not available")
+    def test_read_async(self):
+        renderbuffer = gl.Renderbuffer()
+        renderbuffer.set_storage(gl.RenderbufferFormat.RGBA8, (4, 4))
+
+        framebuffer = gl.Framebuffer(((0, 0), (4, 4)))
+        framebuffer.attach_renderbuffer(gl.Framebuffer.ColorAttachment(0), renderbuffer)
+
+        gl.Renderer.clear_color = Color4(1.0, 0.5, 0.75)
+        framebuffer.clear(gl.FramebufferClear.COLOR)
+
+        read = framebuffer.read_async(Range2Di.from_size((1, 1), (2, 2)), PixelFormat.RGBA8UNORM)
+        a = read.wait()
+        self.assertIsInstance(a, ImageView2D)
+        self.assertEqual(a.size, Vector2i(2, 2))
+        self.assertEqual(a.format, PixelFormat.RGBA8UNORM)
+        self.assertEqual(a.pixels[0, 0, 0], 0xff)
+        self.assertEqual(a.pixels[0, 1, 1], 0x80)
+        self.assertEqual(a.pixels[1, 0, 2], 0xbf)
+
+        # The view keeps the read alive, polling returns the same data
+        self.assertIs(a.owner, read)
+        b = read.poll()
+        self.assertEqual(bytes(b.data), bytes(a.data))
+
+        del read
+        self.assertEqual(a.pixels[1, 1, 0], 0xff)
 
 class Mesh(GLTestCase):
     def test_init(self):
@@ -138,6 +617,301 @@ class Mesh(GLTestCase):
         del mesh
         self.assertEqual(sys.getrefcount(buffer), buffer_refcount)
 
+    def test_set_instance_count(self):
+        a = gl.Mesh()
+        self.assertEqual(a.instance_count, 1)
+        a.instance_count = 1024
+        self.assertEqual(a.instance_count, 1024)
+
+    def test_add_buffer_instanced(self):
+        buffer = gl.Buffer()
+        buffer_refcount = sys.getrefcount(buffer)
+
+        # Adding a buffer to the mesh should increase its ref count
+        mesh = gl.Mesh()
+        mesh.add_vertex_buffer_instanced(buffer, 1, 0, 16, gl.Attribute(gl.Attribute.Kind.GENERIC, 3, gl.Attribute.Components.FOUR, gl.Attribute.DataType.FLOAT))
+        self.assertEqual(len(mesh.buffers), 1)
+        self.assertIs(mesh.buffers[0], buffer)
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount + 1)
+
+        # Deleting the mesh should decrease it again
+        del mesh
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount)
+
+    def test_set_index_buffer(self):
+        buffer = gl.Buffer(gl.Buffer.TargetHint.ELEMENT_ARRAY)
+        buffer.set_data(array.array('H', [0, 1, 2, 2, 1, 3]))
+        buffer_refcount = sys.getrefcount(buffer)
+
+        mesh = gl.Mesh()
+        self.assertFalse(mesh.is_indexed)
+        self.assertIs(mesh.index_type, None)
+
+        mesh.set_index_buffer(buffer, 0, MeshIndexType.UNSIGNED_SHORT, 0, 3)
+        self.assertTrue(mesh.is_indexed)
+        self.assertEqual(mesh.index_type, gl.MeshIndexType.UNSIGNED_SHORT)
+        self.assertEqual(len(mesh.buffers), 1)
+        self.assertIs(mesh.buffers[0], buffer)
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount + 1)
+
+        mesh.set_index_buffer(buffer, 4, gl.MeshIndexType.UNSIGNED_BYTE)
+        self.assertEqual(mesh.index_type, gl.MeshIndexType.UNSIGNED_BYTE)
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount + 2)
+
+        del mesh
+        self.assertEqual(sys.getrefcount(buffer), buffer_refcount)
+
+    def test_set_index_buffer_invalid(self):
+        mesh = gl.Mesh()
+
+        with self.assertRaisesRegex(TypeError, "expected MeshIndexType or gl.MeshIndexType, got <class 'str'>"):
+            mesh.set_index_buffer(gl.Buffer(), 0, "ahaha")
+
+    def test_set_base_vertex(self):
+        a = gl.Mesh()
+        a.base_vertex = 15
+        self.assertEqual(a.base_vertex, 15)
+
+class MeshView(GLTestCase):
+    def test_init(self):
+        mesh = gl.Mesh()
+        mesh_refcount = sys.getrefcount(mesh)
+
+        # Creating a view should increase mesh ref count
+        view = gl.MeshView(mesh)
+        self.assertIs(view.mesh, mesh)
+        self.assertEqual(sys.getrefcount(mesh), mesh_refcount + 1)
+
+        # Deleting the view should decrease it again
+        del view
+        self.assertEqual(sys.getrefcount(mesh), mesh_refcount)
+
+    def test_properties(self):
+        view = gl.MeshView(gl.Mesh())
+        view.count = 15
+        view.base_vertex = 3
+        view.instance_count = 7
+        view.set_index_range(6, 0, 12)
+        self.assertEqual(view.count, 15)
+        self.assertEqual(view.base_vertex, 3)
+        self.assertEqual(view.instance_count, 7)
+
+    def test_draw_many_invalid(self):
+        a = gl.MeshView(gl.Mesh())
+        b = gl.MeshView(gl.Mesh())
+
+        with self.assertRaisesRegex(ValueError, "all views have to be of the same mesh"):
+            gl.MeshView.draw_many(shaders.VertexColor3D(), [a, b])
+
+        c = gl.MeshView(a.mesh)
+        c.instance_count = 3
+        with self.assertRaisesRegex(ValueError, "can't multi-draw instanced views"):
+            gl.MeshView.draw_many(shaders.VertexColor3D(), [a, c])
+
+class Texture(GLTestCase):
+    def test_texture_2d(self):
+        a = gl.Texture2D()
+        self.assertNotEqual(a.id, 0)
+        a.set_minification_filter(gl.SamplerFilter.LINEAR, gl.SamplerMipmap.LINEAR)
+        a.set_magnification_filter(gl.SamplerFilter.LINEAR)
+        a.set_wrapping(gl.SamplerWrapping.CLAMP_TO_EDGE)
+        a.set_storage(3, gl.TextureFormat.RGBA8, (4, 4))
+        a.set_sub_image(0, (2, 0), ImageView2D(PixelFormat.RGBA8UNORM, (2, 4), b'\xff'*32))
+        a.set_sub_image(0, (0, 0), MutableImageView2D(PixelFormat.RGBA8UNORM, (2, 4), bytearray(32)))
+        a.generate_mipmap()
+        a.bind(0)
+
+    @unittest.skipUnless(hasattr(gl.Texture2D, 'set_sub_image_async'), "async upload not available")
+    def test_texture_2d_set_sub_image_async(self):
+        a = gl.Texture2D()
+        a.set_storage(1, gl.TextureFormat.RGBA8, (2, 2))
+        upload = a.set_sub_image_async(0, (0, 0), ImageView2D(PixelFormat.RGBA8UNORM, (2, 2), b'\x00\x40\x80\xff'*4))
+        self.assertTrue(upload.wait(10.0))
+
+        framebuffer = gl.Framebuffer(((0, 0), (2, 2)))
+        framebuffer.attach_texture(gl.Framebuffer.ColorAttachment(0), a, 0)
+        out = bytearray(16)
+        framebuffer.read(((0, 0), (2, 2)), MutableImageView2D(PixelFormat.RGBA8UNORM, (2, 2), out))
+        self.assertEqual(out, b'\x00\x40\x80\xff'*4)
+
+        # Dropping an unfinished upload finishes it instead of discarding
+        upload = a.set_sub_image_async(0, (0, 0), ImageView2D(PixelFormat.RGBA8UNORM, (2, 2), b'\xff\x80\x40\x00'*4))
+        del upload
+        framebuffer.read(((0, 0), (2, 2)), MutableImageView2D(PixelFormat.RGBA8UNORM, (2, 2), out))
+        self.assertEqual(out, b'\xff\x80\x40\x00'*4)
+
+    # Needs OES_texture_3D on ES2
+    @unittest.skipUnless(hasattr(gl, 'Texture3D') and not gles2, "3D textures not available")
+    def test_texture_3d(self):
+        a = gl.Texture3D()
+        a.set_storage(1, gl.TextureFormat.R8, (4, 4, 2))
+        a.set_sub_image(0, (0, 0, 1), ImageView3D(PixelFormat.R8UNORM, (4, 4, 1), b'\xff'*16))
+
+    @unittest.skipUnless(hasattr(gl, 'Texture2DArray'), "texture arrays not available")
+    def test_texture_2d_array(self):
+        a = gl.Texture2DArray()
+        a.set_storage(1, gl.TextureFormat.RGBA8, (4, 4, 3))
+        a.set_sub_image(0, (0, 0, 2), ImageView3D(PixelFormat.RGBA8UNORM, (4, 4, 1), b'\xff'*64))
+
+    def test_cube_map(self):
+        a = gl.CubeMapTexture()
+        a.set_storage(1, gl.TextureFormat.RGBA8, (4, 4))
+        a.set_sub_image(gl.CubeMapCoordinate.NEGATIVE_Z, 0, (0, 0), ImageView2D(PixelFormat.RGBA8UNORM, (4, 4), b'\xff'*64))
+
+# Timer queries need an extension on ES, which SwiftShader doesn't have
+@unittest.skipUnless(hasattr(gl, 'TimeQuery') and not gles, "timer queries not available")
+class TimeQuery(GLTestCase):
+    def test(self):
+        a = gl.TimeQuery()
+        self.assertNotEqual(a.id, 0)
+
+        a.begin()
+        gl.default_framebuffer.clear(gl.FramebufferClear.COLOR)
+        a.end()
+
+        # Blocks until the result is available
+        self.assertGreaterEqual(a.result, 0)
+        self.assertTrue(a.result_available)
+
+    def test_timestamp(self):
+        a = gl.TimeQuery(gl.TimeQuery.Target.TIMESTAMP)
+        b = gl.TimeQuery(gl.TimeQuery.Target.TIMESTAMP)
+        a.timestamp()
+        b.timestamp()
+        self.assertGreaterEqual(b.result, a.result)
+
+class SampleQuery(GLTestCase):
+    def test(self):
+        a = gl.SampleQuery(gl.SampleQuery.Target.ANY_SAMPLES_PASSED)
+        self.assertNotEqual(a.id, 0)
+
+        a.begin()
+        a.end()
+        self.assertEqual(a.result, 0)
+
+    @unittest.skipUnless(hasattr(gl.SampleQuery, 'ConditionalRenderMode'), "conditional render not available")
+    def test_conditional_render(self):
+        a = gl.SampleQuery(gl.SampleQuery.Target.ANY_SAMPLES_PASSED)
+        a.begin()
+        a.end()
+
+        a.begin_conditional_render(gl.SampleQuery.ConditionalRenderMode.WAIT)
+        a.end_conditional_render()
+
+@unittest.skipUnless(hasattr(gl, 'OcclusionCuller'), "occlusion culler not available")
+class OcclusionCuller(GLTestCase):
+    def test(self):
+        # SceneGraph is an optional component
+        try:
+            from magnum import scenegraph
+            from magnum.scenegraph.matrix import Object3D, Scene3D
+        except ImportError:
+            self.skipTest("scenegraph not available")
+
+        color = gl.Renderbuffer()
+        color.set_storage(gl.RenderbufferFormat.RGBA8, (4, 4))
+        depth = gl.Renderbuffer()
+        depth.set_storage(gl.RenderbufferFormat.DEPTH_COMPONENT24, (4, 4))
+        framebuffer = gl.Framebuffer(((0, 0), (4, 4)))
+        framebuffer.attach_renderbuffer(gl.Framebuffer.ColorAttachment(0), color)
+        framebuffer.attach_renderbuffer(gl.Framebuffer.BufferAttachment.DEPTH, depth)
+        framebuffer.bind()
+
+        scene = Scene3D()
+        drawables = scenegraph.DrawableGroup3D()
+        camera = scenegraph.Camera3D(Object3D(scene))
+        camera.projection_matrix = Matrix4.perspective_projection(Deg(60.0), 1.0, 0.1, 100.0)
+
+        drawn = []
+        class MyDrawable(scenegraph.Drawable3D):
+            def draw(self, transformation_matrix: Matrix4, camera: scenegraph.Camera3D):
+                drawn.append(self)
+
+        # In front of the camera
+        a_object = Object3D(scene)
+        a_object.translate((0.0, 0.0, -5.0))
+        a = MyDrawable(a_object, drawables)
+        a.bounding_box = Range3D((-1.0, -1.0, -1.0), (1.0, 1.0, 1.0))
+
+        # Behind the camera
+        b_object = Object3D(scene)
+        b_object.translate((0.0, 0.0, 5.0))
+        b = MyDrawable(b_object, drawables)
+        b.bounding_box = Range3D((-1.0, -1.0, -1.0), (1.0, 1.0, 1.0))
+
+        # No bounding box, always drawn
+        c = MyDrawable(Object3D(scene), drawables)
+
+        culler = gl.OcclusionCuller()
+
+        # Everything is drawn at first, as there are no query results yet
+        framebuffer.clear(gl.FramebufferClear.COLOR|gl.FramebufferClear.DEPTH)
+        culler.draw(drawables, camera)
+        self.assertEqual(drawn, [a, b, c])
+        self.assertEqual(culler.drawn_count, 3)
+        self.assertEqual(culler.culled_count, 0)
+
+        # Query results arrive asynchronously, so draw until they do. Until
+        # then everything is still drawn.
+        for i in range(1000):
+            drawn.clear()
+            framebuffer.clear(gl.FramebufferClear.COLOR|gl.FramebufferClear.DEPTH)
+            culler.draw(drawables, camera)
+            if culler.culled_count: break
+        self.assertEqual(drawn, [a, c])
+        self.assertEqual(culler.drawn_count, 2)
+        self.assertEqual(culler.culled_count, 1)
+
+# Uses timestamp queries, so the same restrictions as for TimeQuery apply
+@unittest.skipUnless(hasattr(gl, 'FrameProfiler') and not gles, "timer queries not available")
+class FrameProfiler(GLTestCase):
+    def test(self):
+        a = gl.FrameProfiler(max_frames=2)
+        self.assertEqual(a.max_frames, 2)
+
+        for i in range(3):
+            a.begin_frame()
+            with a.scope("clear"):
+                gl.default_framebuffer.clear(gl.FramebufferClear.COLOR)
+                with a.scope("nested \"clear\""):
+                    gl.default_framebuffer.clear(gl.FramebufferClear.COLOR)
+            a.end_frame()
+
+        # Two frames at most are kept, either ready already or still waiting
+        # for query results
+        records = a.records
+        self.assertLessEqual(len(records), 4)
+        for frame, name, depth, cpu_begin, cpu_duration, gpu_begin, gpu_duration in records:
+            self.assertIn(frame, [0, 1, 2])
+            self.assertEqual(depth, 0 if name == 'clear' else 1)
+            self.assertGreaterEqual(cpu_duration, 0)
+            self.assertGreaterEqual(gpu_duration, 0)
+
+        trace = a.trace_json()
+        self.assertTrue(trace.startswith('{"traceEvents":['))
+        if records:
+            self.assertIn('"name":"nested \\"clear\\""', trace)
+
+    def test_invalid(self):
+        a = gl.FrameProfiler()
+        with self.assertRaisesRegex(RuntimeError, "no frame in progress"):
+            a.begin("hello")
+        with self.assertRaisesRegex(RuntimeError, "no frame in progress"):
+            a.end_frame()
+
+        a.begin_frame()
+        with self.assertRaisesRegex(RuntimeError, "a frame is already in progress"):
+            a.begin_frame()
+        with self.assertRaisesRegex(RuntimeError, "no section in progress"):
+            a.end()
+
+        a.begin("hello")
+        with self.assertRaisesRegex(RuntimeError, "section hello is not ended"):
+            a.end_frame()
+
+        with self.assertRaisesRegex(ValueError, "max frame count can't be zero"):
+            gl.FrameProfiler(0)
+
 class Renderbuffer(GLTestCase):
     def test_init(self):
         renderbuffer = gl.Renderbuffer()
@@ -149,3 +923,112 @@ class Renderer(GLTestCase):
         gl.Renderer.enable(gl.Renderer.Feature.DEPTH_TEST)
         gl.Renderer.disable(gl.Renderer.Feature.FACE_CULLING)
         gl.Renderer.set_feature(gl.Renderer.Feature.STENCIL_TEST, True)
+
+    def test_apply(self):
+        gl.Renderer.reset_state_cache()
+        gl.Renderer.enable(gl.Renderer.Feature.BLENDING)
+
+        gl.enable_stats()
+        gl.reset_stats()
+        gl.Renderer.apply({
+            gl.Renderer.Feature.BLENDING: True,
+            gl.Renderer.Feature.DEPTH_TEST: False,
+            gl.Renderer.Feature.FACE_CULLING: True
+        })
+        stats = gl.stats()
+        gl.enable_stats(False)
+        self.assertEqual(stats['state_changes'], 3)
+        self.assertEqual(stats['redundant_state_changes'], 1)
+
+    def test_apply_invalid(self):
+        with self.assertRaisesRegex(TypeError, "expected Renderer.Feature, got <class 'str'>"):
+            gl.Renderer.apply({'blending': True})
+        with self.assertRaisesRegex(TypeError, "expected bool, got <class 'str'>"):
+            gl.Renderer.apply({gl.Renderer.Feature.BLENDING: 'yes'})
+
+class Stats(GLTestCase):
+    def tearDown(self):
+        gl.enable_stats(False)
+        gl.reset_stats()
+
+    def test_disabled(self):
+        gl.reset_stats()
+        a = gl.Buffer()
+        a.set_data(b'hello')
+        gl.Renderer.enable(gl.Renderer.Feature.DEPTH_TEST)
+        self.assertEqual(gl.stats()['uploads'], 0)
+        self.assertEqual(gl.stats()['state_changes'], 0)
+
+    def test_buffer(self):
+        gl.enable_stats()
+        gl.reset_stats()
+
+        a = gl.Buffer()
+        a.set_data(b'hello world', gl.BufferUsage.DYNAMIC_DRAW)
+        a.set_sub_data(6, b'WORLD')
+        self.assertEqual(a.sub_data(0, 5), b'hello')
+
+        stats = gl.stats()
+        self.assertEqual(stats['uploads'], 2)
+        self.assertEqual(stats['bytes_uploaded'], 16)
+        self.assertEqual(stats['downloads'], 1)
+        self.assertEqual(stats['bytes_downloaded'], 5)
+        self.assertEqual(stats['static_reuploads'], 0)
+
+        gl.reset_stats()
+        self.assertEqual(gl.stats()['uploads'], 0)
+
+    def test_static_reupload(self):
+        gl.enable_stats()
+        gl.reset_stats()
+
+        a = gl.Buffer()
+        a.set_data(b'hello', gl.BufferUsage.STATIC_DRAW)
+        self.assertEqual(gl.stats()['static_reuploads'], 0)
+
+        # Static buffers are remembered across resets
+        gl.reset_stats()
+        a.set_data(b'hello', gl.BufferUsage.STATIC_DRAW)
+        a.set_sub_data(0, b'HELLO')
+        self.assertEqual(gl.stats()['static_reuploads'], 2)
+
+        # A buffer reusing the ID of a deleted static buffer isn't static
+        id = a.id
+        del a
+        b = gl.Buffer()
+        if b.id == id:
+            gl.reset_stats()
+            b.set_data(b'hello', gl.BufferUsage.DYNAMIC_DRAW)
+            self.assertEqual(gl.stats()['static_reuploads'], 0)
+
+    def test_draw(self):
+        gl.enable_stats()
+        gl.reset_stats()
+
+        mesh = gl.Mesh()
+        mesh.count = 3
+        shader = shaders.VertexColor3D()
+        mesh.draw(shader)
+        view = gl.MeshView(mesh)
+        view.count = 3
+        view.draw(shader)
+        gl.MeshView.draw_many(shader, [view, view])
+        self.assertEqual(gl.stats()['draw_calls'], 4)
+
+    def test_state_changes(self):
+        gl.Renderer.reset_state_cache()
+        gl.enable_stats()
+        gl.reset_stats()
+
+        gl.Renderer.enable(gl.Renderer.Feature.DEPTH_TEST)
+        gl.Renderer.enable(gl.Renderer.Feature.DEPTH_TEST)
+        gl.Renderer.set_feature(gl.Renderer.Feature.DEPTH_TEST, False)
+        gl.Renderer.disable(gl.Renderer.Feature.DEPTH_TEST)
+        gl.Renderer.clear_color = Color4(0.5, 0.5, 0.5)
+        gl.Renderer.clear_color = Color4(0.5, 0.5, 0.5)
+        gl.default_framebuffer.bind()
+
+        stats = gl.stats()
+        self.assertEqual(stats['state_changes'], 6)
+        self.assertEqual(stats['redundant_state_changes'], 3)
+        self.assertEqual(stats['framebuffer_binds'], 1)
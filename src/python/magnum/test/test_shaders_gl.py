@@ -23,6 +23,9 @@
 #   DEALINGS IN THE SOFTWARE.
 #
 
+import array
+import ctypes
+import sys
 import unittest
 
 # setUpModule gets called before everything else, skipping if GL tests can't
@@ -30,7 +33,7 @@ import unittest
 from . import GLTestCase, setUpModule
 
 from magnum import *
-from magnum import shaders
+from magnum import gl, shaders
 
 class VertexColor(GLTestCase):
     def test_init(self):
@@ -43,6 +46,23 @@ class VertexColor(GLTestCase):
             Matrix3.translation(Vector2.x_axis())@
             Matrix3.rotation(Deg(35.0)))
 
+    def test_draw_many(self):
+        mesh = gl.Mesh()
+        mesh.count = 3
+        matrices = memoryview(array.array('f', [0.0]*18)).cast('B').cast('f', [2, 3, 3])
+
+        a = shaders.VertexColor2D()
+        gl.enable_stats()
+        gl.reset_stats()
+        a.draw_many([mesh, mesh], matrices)
+        self.assertEqual(gl.stats()['draw_calls'], 2)
+        gl.enable_stats(False)
+
+        with self.assertRaisesRegex(ValueError, "expected 1 transformation projection matrices but got 2"):
+            a.draw_many([mesh], matrices)
+        with self.assertRaisesRegex(BufferError, "expected 4x4 elements for transformation projection matrices but got 3x3"):
+            shaders.VertexColor3D().draw_many([mesh, mesh], matrices)
+
 class Phong(GLTestCase):
     def test_init(self):
         a = shaders.Phong()
@@ -64,3 +84,76 @@ class Phong(GLTestCase):
         a.projection_matrix = Matrix4.zero_init()
         a.light_positions = [(0.5, 1.0, 0.3)]
         a.light_colors = [Color4()]
+
+    def test_light_buffers(self):
+        a = shaders.Phong(shaders.Phong.Flags.NONE, 2)
+
+        # Contiguous float buffers are used directly
+        a.light_positions = memoryview(array.array('f', [0.5, 1.0, 0.3, 0.0, 1.0, 0.0])).cast('B').cast('f', [2, 3])
+        a.light_colors = memoryview(array.array('f', [1.0]*8)).cast('B').cast('f', [2, 4])
+
+        # Explicit native byte order, such as what ctypes produces
+        positions = (ctypes.c_float*3*2)()
+        self.assertEqual(memoryview(positions).format, '<f' if sys.byteorder == 'little' else '>f')
+        a.light_positions = positions
+
+        # Doubles get converted
+        a.light_positions = memoryview(array.array('d', [0.5, 1.0, 0.3, 0.0, 1.0, 0.0])).cast('B').cast('d', [2, 3])
+
+        # Lists still work
+        a.light_positions = [(0.5, 1.0, 0.3), Vector3()]
+        a.light_colors = [Color4(), (1.0, 0.5, 0.2, 1.0)]
+
+    def test_light_buffers_invalid(self):
+        a = shaders.Phong(shaders.Phong.Flags.NONE, 2)
+        with self.assertRaisesRegex(ValueError, "expected 2 light positions but got 1"):
+            a.light_positions = [(0.5, 1.0, 0.3)]
+        with self.assertRaisesRegex(ValueError, "expected 2 light colors but got 3"):
+            a.light_colors = memoryview(array.array('f', [1.0]*12)).cast('B').cast('f', [3, 4])
+        with self.assertRaises(TypeError):
+            a.light_positions = memoryview(array.array('f', [1.0]*8)).cast('B').cast('f', [2, 4])
+        with self.assertRaises(TypeError):
+            a.light_positions = memoryview(array.array('i', [1]*6)).cast('B').cast('i', [2, 3])
+
+    def test_bind_textures(self):
+        texture = gl.Texture2D()
+        texture.set_storage(1, gl.TextureFormat.RGBA8, (4, 4))
+
+        a = shaders.Phong(shaders.Phong.Flags.AMBIENT_TEXTURE|shaders.Phong.Flags.DIFFUSE_TEXTURE|shaders.Phong.Flags.SPECULAR_TEXTURE)
+        a.bind_ambient_texture(texture)
+        a.bind_diffuse_texture(texture)
+        a.bind_specular_texture(texture)
+
+    def test_bind_textures_invalid(self):
+        a = shaders.Phong()
+        with self.assertRaisesRegex(ValueError, "the shader was not created with ambient texture enabled"):
+            a.bind_ambient_texture(gl.Texture2D())
+        with self.assertRaisesRegex(ValueError, "the shader was not created with diffuse texture enabled"):
+            a.bind_diffuse_texture(gl.Texture2D())
+        with self.assertRaisesRegex(ValueError, "the shader was not created with specular texture enabled"):
+            a.bind_specular_texture(gl.Texture2D())
+
+    def test_draw_many(self):
+        mesh = gl.Mesh()
+        mesh.count = 3
+        transformations = memoryview(array.array('f', [0.0]*32)).cast('B').cast('f', [2, 4, 4])
+        normals = memoryview(array.array('f', [0.0]*18)).cast('B').cast('f', [2, 3, 3])
+        colors = memoryview(array.array('f', [0.0]*8)).cast('B').cast('f', [2, 4])
+
+        a = shaders.Phong()
+        a.draw_many([mesh, mesh], transformations)
+        a.draw_many([mesh, mesh], transformations, normals, colors)
+
+    def test_draw_many_invalid(self):
+        mesh = gl.Mesh()
+        transformations = memoryview(array.array('f', [0.0]*32)).cast('B').cast('f', [2, 4, 4])
+
+        a = shaders.Phong()
+        with self.assertRaisesRegex(ValueError, "expected 3 transformation matrices but got 2"):
+            a.draw_many([mesh, mesh, mesh], transformations)
+        with self.assertRaisesRegex(BufferError, "expected 3 dimensions for normal matrices but got 1"):
+            a.draw_many([mesh, mesh], transformations, array.array('f', [0.0]*18))
+        with self.assertRaisesRegex(BufferError, "expected 4 elements for diffuse colors but got 3"):
+            a.draw_many([mesh, mesh], transformations, diffuse_colors=memoryview(array.array('f', [0.0]*6)).cast('B').cast('f', [2, 3]))
+        with self.assertRaisesRegex(BufferError, "expected format f for transformation matrices but got d"):
+            a.draw_many([mesh, mesh], memoryview(array.array('d', [0.0]*32)).cast('B').cast('d', [2, 4, 4]))